@@ -1,11 +1,14 @@
 #pragma once
 
 #include "../export.hpp"
+#include "../delegate.hpp"
 #include <type_traits>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <vector>
-#include <functional>
 
 namespace cu::ai
 {
@@ -17,10 +20,42 @@ enum class BTStatus
     success
 };
 
+using BTClock = std::chrono::steady_clock;
+
+// Lets FlatBehaviourTree recognize the built-in nodes. It only trusts the
+// kind of the built-in classes themselves, subclasses keep their own tick()
+// and are treated as custom nodes.
+enum class BTNodeKind : uint8_t
+{
+    custom,
+    tree,
+    fallback,
+    sequence,
+    action,
+    agentAction,
+    coroutineAction
+};
+
+// How far a sequence or fallback gets in one tick. Single step ticks one
+// child and returns running if there are more to go. Run to completion
+// keeps ticking children until one is running or the node has a result.
+enum class BTTickMode : uint8_t
+{
+    singleStep,
+    runToCompletion
+};
+
 class BTNode
 {
 public:
+    virtual ~BTNode() noexcept = default;
+
     virtual BTStatus tick() = 0;
+
+    virtual BTNodeKind kind() const noexcept
+    {
+        return BTNodeKind::custom;
+    }
 };
 
 template<typename TNode>
@@ -41,10 +76,20 @@ public:
         return ptr;
     }
 
+    BTNode* root() const noexcept
+    {
+        return _root.get();
+    }
+
     BTStatus tick() override
     {
         return nullptr == _root ? BTStatus::failure : _root->tick();
     }
+
+    BTNodeKind kind() const noexcept override
+    {
+        return BTNodeKind::tree;
+    }
 };
 
 class BTControlNode : public BTNode
@@ -52,9 +97,20 @@ class BTControlNode : public BTNode
 protected:
     size_t                               _currentNodeIndex{};
     std::vector<std::unique_ptr<BTNode>> _children{};
+    BTTickMode                           _tickMode{};
 public:
     virtual ~BTControlNode() noexcept = default;
 
+    BTTickMode tickMode() const noexcept
+    {
+        return _tickMode;
+    }
+
+    void setTickMode(BTTickMode tickMode) noexcept
+    {
+        _tickMode = tickMode;
+    }
+
     template<InheritsBTNode TNode, typename... TArgs>
     TNode* createChild(TArgs&&... args)
     {
@@ -64,28 +120,25 @@ public:
 
         return ptr;
     }
+
+    const std::vector<std::unique_ptr<BTNode>>& children() const noexcept
+    {
+        return _children;
+    }
 };
 
 class BTFallback : public BTControlNode
 {
-
 public:
-    BTStatus tick() override
+    BTNodeKind kind() const noexcept override
     {
-        if (_currentNodeIndex >= _children.size())
-        {
-            _currentNodeIndex = 0;
-
-            return BTStatus::failure;
-        }
-
-        auto status = _children[_currentNodeIndex]->tick();
+        return BTNodeKind::fallback;
+    }
 
-        switch (status)
+    BTStatus tick() override
+    {
+        while (true)
         {
-        case BTStatus::failure:
-            ++this->_currentNodeIndex;
-
             if (_currentNodeIndex >= _children.size())
             {
                 _currentNodeIndex = 0;
@@ -93,75 +146,144 @@ public:
                 return BTStatus::failure;
             }
 
-            break;
+            auto status = _children[_currentNodeIndex]->tick();
 
-        case BTStatus::success:
-            _currentNodeIndex = 0;
-            return BTStatus::success;
+            switch (status)
+            {
+            case BTStatus::failure:
+                ++this->_currentNodeIndex;
 
-        default:
-            break;
-        }
+                if (_currentNodeIndex >= _children.size())
+                {
+                    _currentNodeIndex = 0;
+
+                    return BTStatus::failure;
+                }
+
+                if (BTTickMode::runToCompletion == _tickMode)
+                    continue;
+
+                break;
+
+            case BTStatus::success:
+                _currentNodeIndex = 0;
+                return BTStatus::success;
+
+            default:
+                break;
+            }
 
-        return BTStatus::running;
+            return BTStatus::running;
+        }
     }
 };
 
 class BTSequence : public BTControlNode
 {
 public:
+    BTNodeKind kind() const noexcept override
+    {
+        return BTNodeKind::sequence;
+    }
+
     BTStatus tick() override
     {
-        if (_currentNodeIndex >= _children.size())
+        while (true)
         {
-            _currentNodeIndex = 0;
+            if (_currentNodeIndex >= _children.size())
+            {
+                _currentNodeIndex = 0;
 
-            return BTStatus::failure;
-        }
+                return BTStatus::failure;
+            }
 
-        auto status = _children[_currentNodeIndex]->tick();
+            auto status = _children[_currentNodeIndex]->tick();
 
-        switch (status)
-        {
-        case BTStatus::failure:
-            _currentNodeIndex = 0;
+            switch (status)
+            {
+            case BTStatus::failure:
+                _currentNodeIndex = 0;
 
-            return BTStatus::failure;
+                return BTStatus::failure;
 
-        case BTStatus::running:
-            return BTStatus::running;
+            case BTStatus::running:
+                return BTStatus::running;
 
-        case BTStatus::success:
-            ++_currentNodeIndex;
+            case BTStatus::success:
+                ++_currentNodeIndex;
 
-            if (_currentNodeIndex >= _children.size())
-            {
-                _currentNodeIndex = 0;
+                if (_currentNodeIndex >= _children.size())
+                {
+                    _currentNodeIndex = 0;
 
-                return BTStatus::success;
+                    return BTStatus::success;
+                }
+
+                if (BTTickMode::runToCompletion == _tickMode)
+                    continue;
             }
-        }
 
-        return BTStatus::running;
+            return BTStatus::running;
+        }
     }
 };
 
 class BTAction : public BTNode
 {
-    std::function<BTStatus(void)> _action;
+    Delegate<BTStatus(void)> _action;
 
 public:
-    BTAction(std::function<BTStatus(void)> action) noexcept
+    BTAction(Delegate<BTStatus(void)> action) noexcept
         : _action{std::move(action)}
     {
     }
 
     virtual ~BTAction() noexcept = default;
 
+    const Delegate<BTStatus(void)>& action() const noexcept
+    {
+        return _action;
+    }
+
     BTStatus tick() override
     {
         return _action();
     }
+
+    BTNodeKind kind() const noexcept override
+    {
+        return BTNodeKind::action;
+    }
+};
+
+class BTAgent;
+
+// An action that is told which agent it runs for, see BTAgent. Only trees
+// compiled into a FlatBehaviourTree and ticked for an agent can run it.
+class BTAgentAction : public BTNode
+{
+    Delegate<BTStatus(BTAgent&)> _action;
+
+public:
+    BTAgentAction(Delegate<BTStatus(BTAgent&)> action) noexcept
+        : _action{std::move(action)}
+    {
+    }
+
+    const Delegate<BTStatus(BTAgent&)>& action() const noexcept
+    {
+        return _action;
+    }
+
+    BTStatus tick() override
+    {
+        throw std::runtime_error("BTAgentAction needs an agent to tick.");
+    }
+
+    BTNodeKind kind() const noexcept override
+    {
+        return BTNodeKind::agentAction;
+    }
 };
 
-}
\ No newline at end of file
+}
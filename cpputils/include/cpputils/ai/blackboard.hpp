@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cu::ai
+{
+
+class BlackboardLayout;
+class Blackboard;
+
+// Names a value of type T in blackboards of the layout that made it. The
+// key is just the offset of the value, so looking it up is an addition.
+template<typename T>
+class BlackboardKey
+{
+    friend BlackboardLayout;
+
+    uint32_t _offset;
+
+    explicit BlackboardKey(uint32_t offset) noexcept
+        : _offset{offset}
+    {
+    }
+
+public:
+    uint32_t offset() const noexcept
+    {
+        return _offset;
+    }
+};
+
+// The typed entries of a blackboard and their initial values. Entries are
+// placed at fixed offsets as they are added, so a layout must be complete
+// before blackboards are made from it.
+class BlackboardLayout
+{
+    friend Blackboard;
+
+    struct Entry
+    {
+        uint32_t                    offset;
+        std::shared_ptr<const void> initial;
+        void (*copy)(void* target, const void* source);
+        void (*destroy)(void* value) noexcept;
+    };
+
+    std::vector<Entry> _entries{};
+    size_t             _size{};
+    size_t             _alignment{1};
+    bool               _trivial{true};
+
+public:
+    template<std::copy_constructible T>
+        requires std::same_as<T, std::remove_cvref_t<T>>
+    BlackboardKey<T> add(T initial = T{})
+    {
+        auto offset = (_size + alignof(T) - 1) & ~(alignof(T) - 1);
+        _size       = offset + sizeof(T);
+        _alignment  = std::max(_alignment, alignof(T));
+        _trivial    = _trivial && std::is_trivially_copyable_v<T>;
+
+        _entries.push_back(Entry{
+            static_cast<uint32_t>(offset),
+            std::make_shared<const T>(std::move(initial)),
+            [](void* target, const void* source)
+            { ::new (target) T(*static_cast<const T*>(source)); },
+            [](void* value) noexcept { static_cast<T*>(value)->~T(); }});
+
+        return BlackboardKey<T>{static_cast<uint32_t>(offset)};
+    }
+
+    size_t keyCount() const noexcept
+    {
+        return _entries.size();
+    }
+
+    // Bytes a blackboard of this layout stores its values in.
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+};
+
+// One contiguous block holding a value for every key of a layout. Reading
+// and writing a key neither hashes nor allocates.
+//
+// One key can be watched for writes made through set(); writes through
+// operator[] are not noticed.
+class Blackboard
+{
+    static constexpr uint32_t noKey = UINT32_MAX;
+
+    std::shared_ptr<const BlackboardLayout> _layout{};
+    std::byte*                              _data{};
+    uint32_t                                _watched{noKey};
+    bool                                    _watchedChanged{};
+
+public:
+    Blackboard() = default;
+
+    explicit Blackboard(std::shared_ptr<const BlackboardLayout> layout)
+        : _layout{std::move(layout)}
+    {
+        if (nullptr != _layout)
+            construct([](const BlackboardLayout::Entry& entry)
+                      { return entry.initial.get(); });
+    }
+
+    ~Blackboard()
+    {
+        release();
+    }
+
+    Blackboard(Blackboard&& other) noexcept
+        : _layout{std::move(other._layout)}
+        , _data{std::exchange(other._data, nullptr)}
+        , _watched{std::exchange(other._watched, noKey)}
+        , _watchedChanged{std::exchange(other._watchedChanged, false)}
+    {
+    }
+
+    Blackboard& operator=(Blackboard&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        release();
+        _layout         = std::move(other._layout);
+        _data           = std::exchange(other._data, nullptr);
+        _watched        = std::exchange(other._watched, noKey);
+        _watchedChanged = std::exchange(other._watchedChanged, false);
+
+        return *this;
+    }
+
+    Blackboard(const Blackboard& other)
+        : _layout{other._layout}
+    {
+        if (nullptr != _layout)
+            construct([&other](const BlackboardLayout::Entry& entry)
+                      { return other._data + entry.offset; });
+    }
+
+    Blackboard& operator=(const Blackboard& other)
+    {
+        if (this != &other)
+            *this = Blackboard{other};
+
+        return *this;
+    }
+
+    template<typename T>
+    T& operator[](BlackboardKey<T> key) noexcept
+    {
+        return *std::launder(reinterpret_cast<T*>(_data + key.offset()));
+    }
+
+    template<typename T>
+    const T& operator[](BlackboardKey<T> key) const noexcept
+    {
+        return *std::launder(reinterpret_cast<const T*>(_data + key.offset()));
+    }
+
+    const BlackboardLayout* layout() const noexcept
+    {
+        return _layout.get();
+    }
+
+    template<typename T, typename TValue>
+    void set(BlackboardKey<T> key, TValue&& value)
+    {
+        (*this)[key] = std::forward<TValue>(value);
+
+        if (key.offset() == _watched)
+            _watchedChanged = true;
+    }
+
+    template<typename T>
+    void watch(BlackboardKey<T> key) noexcept
+    {
+        _watched        = key.offset();
+        _watchedChanged = false;
+    }
+
+    void unwatch() noexcept
+    {
+        _watched        = noKey;
+        _watchedChanged = false;
+    }
+
+    // Whether the watched key was set since watch() was called.
+    bool watchedChanged() const noexcept
+    {
+        return _watchedChanged;
+    }
+
+private:
+    template<typename TSource>
+    void construct(TSource source)
+    {
+        if (0 == _layout->_size)
+            return;
+
+        _data = static_cast<std::byte*>(::operator new(
+            _layout->_size, std::align_val_t{_layout->_alignment}));
+
+        size_t constructed = 0;
+
+        try
+        {
+            for (auto& entry : _layout->_entries)
+            {
+                entry.copy(_data + entry.offset, source(entry));
+                ++constructed;
+            }
+        }
+        catch (...)
+        {
+            destroy(constructed);
+            throw;
+        }
+    }
+
+    void release() noexcept
+    {
+        if (nullptr != _data)
+            destroy(_layout->_entries.size());
+    }
+
+    void destroy(size_t count) noexcept
+    {
+        if (!_layout->_trivial)
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto& entry = _layout->_entries[i];
+                entry.destroy(_data + entry.offset);
+            }
+
+        ::operator delete(_data, std::align_val_t{_layout->_alignment});
+        _data = nullptr;
+    }
+};
+
+}
@@ -0,0 +1,376 @@
+#pragma once
+
+#include "behaviourtree.hpp"
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace cu::ai
+{
+
+// Recycles coroutine frames. Frames up to maxPooledSize bytes are rounded
+// up to a multiple of granularity and kept in a free list per size on the
+// thread that released them, larger ones go to the global allocator.
+class BTFramePool
+{
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct FreeLists
+    {
+        std::array<FreeBlock*, 16> heads{};
+
+        ~FreeLists()
+        {
+            for (auto head : heads)
+                while (nullptr != head)
+                    ::operator delete(std::exchange(head, head->next));
+        }
+    };
+
+    static FreeLists& freeLists() noexcept
+    {
+        thread_local FreeLists lists;
+
+        return lists;
+    }
+
+public:
+    static constexpr size_t granularity   = 64;
+    static constexpr size_t maxPooledSize = 16 * granularity;
+
+    static void* allocate(size_t size)
+    {
+        if (size > maxPooledSize)
+            return ::operator new(size);
+
+        auto& head = freeLists().heads[(size - 1) / granularity];
+
+        if (nullptr == head)
+            return ::operator new(((size - 1) / granularity + 1) * granularity);
+
+        return std::exchange(head, head->next);
+    }
+
+    static void deallocate(void* frame, size_t size) noexcept
+    {
+        if (size > maxPooledSize)
+        {
+            ::operator delete(frame);
+
+            return;
+        }
+
+        auto& head = freeLists().heads[(size - 1) / granularity];
+        head       = ::new (frame) FreeBlock{head};
+    }
+};
+
+// Return type of the body of a BTCoroutineAction. The body runs a step per
+// tick between co_awaits and ends with co_return of success or failure.
+// Time is the tick time of the agent it runs for, not the clock.
+class BTCoroutine
+{
+public:
+    class promise_type
+    {
+        friend BTCoroutine;
+        friend struct BTWaitUntil;
+        friend struct BTSleep;
+        friend struct BTSubtree;
+
+        BTStatus                    _result{BTStatus::failure};
+        std::exception_ptr          _error{};
+        const Delegate<bool(void)>* _condition{};
+        BTClock::time_point         _now{};
+        BTClock::time_point         _wakeTime{};
+        BTNode*                     _subtree{};
+        BTStatus*                   _subtreeStatus{};
+
+    public:
+        static void* operator new(size_t size)
+        {
+            return BTFramePool::allocate(size);
+        }
+
+        static void operator delete(void* frame, size_t size) noexcept
+        {
+            BTFramePool::deallocate(frame, size);
+        }
+
+        BTCoroutine get_return_object() noexcept
+        {
+            return BTCoroutine{
+                std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_value(BTStatus status) noexcept
+        {
+            _result = status;
+        }
+
+        void unhandled_exception() noexcept
+        {
+            _error = std::current_exception();
+        }
+
+    private:
+        // Whether what the body waits for happened, ticking the awaited
+        // subtree if there is one.
+        bool isReady()
+        {
+            if (nullptr != _subtree)
+            {
+                *_subtreeStatus = _subtree->tick();
+
+                if (BTStatus::running == *_subtreeStatus)
+                    return false;
+
+                _subtree = nullptr;
+            }
+
+            if (nullptr != _condition)
+            {
+                if (!(*_condition)())
+                    return false;
+
+                _condition = nullptr;
+            }
+
+            return _now >= _wakeTime;
+        }
+    };
+
+private:
+    std::coroutine_handle<promise_type> _handle{};
+
+    explicit BTCoroutine(std::coroutine_handle<promise_type> handle) noexcept
+        : _handle{handle}
+    {
+    }
+
+public:
+    BTCoroutine() = default;
+
+    ~BTCoroutine()
+    {
+        if (_handle)
+            _handle.destroy();
+    }
+
+    BTCoroutine(BTCoroutine&& other) noexcept
+        : _handle{std::exchange(other._handle, nullptr)}
+    {
+    }
+
+    BTCoroutine& operator=(BTCoroutine&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_handle)
+                _handle.destroy();
+
+            _handle = std::exchange(other._handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    BTCoroutine(const BTCoroutine& other)            = delete;
+    BTCoroutine& operator=(const BTCoroutine& other) = delete;
+
+    explicit operator bool() const noexcept
+    {
+        return static_cast<bool>(_handle);
+    }
+
+    // Time a BTSleep in progress ends at, in the past otherwise.
+    BTClock::time_point wakeTime() const noexcept
+    {
+        return _handle.promise()._wakeTime;
+    }
+
+    // Runs the body up to its next suspension unless it is still waiting,
+    // returns running until the body finished.
+    BTStatus resume(BTClock::time_point now)
+    {
+        auto& promise = _handle.promise();
+        promise._now  = now;
+
+        if (!promise.isReady())
+            return BTStatus::running;
+
+        _handle.resume();
+
+        if (promise._error)
+            std::rethrow_exception(promise._error);
+
+        return _handle.done() ? promise._result : BTStatus::running;
+    }
+};
+
+// Suspends the body until the next tick.
+using BTNextTick = std::suspend_always;
+
+// Suspends the body until condition returns true, checked once per tick.
+struct BTWaitUntil
+{
+    Delegate<bool(void)> condition;
+
+    bool await_ready() const
+    {
+        return condition();
+    }
+
+    void await_suspend(
+        std::coroutine_handle<BTCoroutine::promise_type> handle) const noexcept
+    {
+        handle.promise()._condition = &condition;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+// Suspends the body until the first tick at least duration after this one.
+struct BTSleep
+{
+    BTClock::duration duration;
+
+    bool await_ready() const noexcept
+    {
+        return duration <= BTClock::duration::zero();
+    }
+
+    void await_suspend(
+        std::coroutine_handle<BTCoroutine::promise_type> handle) const
+    {
+        auto& promise     = handle.promise();
+        promise._wakeTime = promise._now + duration;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+// Ticks node once per tick, starting right away, until it is no longer
+// running, and resumes the body with its status. The node keeps its own
+// state, so every agent has to await a node of its own.
+struct BTSubtree
+{
+    BTNode&  node;
+    BTStatus status{};
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<BTCoroutine::promise_type> handle)
+    {
+        status = node.tick();
+
+        if (BTStatus::running != status)
+            return false;
+
+        handle.promise()._subtree       = &node;
+        handle.promise()._subtreeStatus = &status;
+
+        return true;
+    }
+
+    BTStatus await_resume() const noexcept
+    {
+        return status;
+    }
+};
+
+// An action whose body is a coroutine, for behaviours that take several
+// ticks. Each tick resumes the body up to its next co_await and returns
+// running until the body co_returns its result. The body is called again
+// for every run.
+//
+// A body without parameters can run in a plain BehaviourTree, where the
+// node keeps the run itself and ticks at the time of the clock. A body
+// that takes the agent only runs in a tree compiled into a
+// FlatBehaviourTree and ticked for a BTAgent, where each agent keeps its
+// own run. The compiled tree keeps one copy of the body, captures of a
+// lambda body included, that the runs of every agent share.
+class BTCoroutineAction : public BTNode
+{
+    Delegate<BTCoroutine(BTAgent&)> _body;
+    Delegate<BTCoroutine(void)>     _standaloneBody{};
+    BTCoroutine                     _run{};
+
+public:
+    BTCoroutineAction(Delegate<BTCoroutine(BTAgent&)> body) noexcept
+        : _body{std::move(body)}
+    {
+    }
+
+    BTCoroutineAction(Delegate<BTCoroutine(void)> body)
+        : _body{[body](BTAgent&) { return body(); }}
+        , _standaloneBody{std::move(body)}
+    {
+    }
+
+    BTCoroutineAction(const BTCoroutineAction& other)            = delete;
+    BTCoroutineAction& operator=(const BTCoroutineAction& other) = delete;
+
+    const Delegate<BTCoroutine(BTAgent&)>& body() const noexcept
+    {
+        return _body;
+    }
+
+    BTStatus tick() override
+    {
+        if (!_standaloneBody)
+            throw std::runtime_error(
+                "BTCoroutineAction needs an agent to tick.");
+
+        if (!_run)
+            _run = _standaloneBody();
+
+        BTStatus status;
+
+        try
+        {
+            status = _run.resume(BTClock::now());
+        }
+        catch (...)
+        {
+            _run = BTCoroutine{};
+            throw;
+        }
+
+        if (BTStatus::running != status)
+            _run = BTCoroutine{};
+
+        return status;
+    }
+
+    BTNodeKind kind() const noexcept override
+    {
+        return BTNodeKind::coroutineAction;
+    }
+};
+
+}
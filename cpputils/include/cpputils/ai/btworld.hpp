@@ -0,0 +1,221 @@
+#pragma once
+
+#include "flatbehaviourtree.hpp"
+#include "../task.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace cu::ai
+{
+
+struct BTAgentId
+{
+    uint32_t group{};
+    uint32_t index{};
+};
+
+// Outcome of ticking every agent of one tree. Suspended agents are the
+// running ones left waiting for a wake condition.
+struct BTBatchResult
+{
+    const FlatBehaviourTree* tree{};
+    size_t                   success{};
+    size_t                   failure{};
+    size_t                   running{};
+    size_t                   suspended{};
+};
+
+// Ticks a population of agents. Agents are grouped by the tree they run
+// and stored in blocks next to each other, so a batch walks one tree's
+// nodes for all of its agents while they are in cache. Agents stay where
+// they are as others are added, which keeps their coroutine actions
+// running.
+class BTWorld
+{
+    struct Group
+    {
+        std::shared_ptr<const FlatBehaviourTree> tree{};
+        std::deque<BTAgent>                      agents{};
+        std::vector<BTStatus>                    statuses{};
+    };
+
+    struct Chunk
+    {
+        uint32_t group{};
+        uint32_t first{};
+        uint32_t last{};
+    };
+
+    std::deque<Group>          _groups{};
+    std::vector<BTBatchResult> _results{};
+
+public:
+    BTAgentId add(std::shared_ptr<const FlatBehaviourTree> tree,
+                  void*                                    userData = nullptr)
+    {
+        auto found = std::find_if(_groups.begin(),
+                                  _groups.end(),
+                                  [&tree](const Group& group)
+                                  { return group.tree == tree; });
+
+        if (_groups.end() == found)
+        {
+            _groups.push_back(Group{.tree = tree});
+            found = _groups.end() - 1;
+        }
+
+        found->agents.emplace_back(std::move(tree), userData);
+        found->statuses.push_back(BTStatus::running);
+
+        return BTAgentId{static_cast<uint32_t>(found - _groups.begin()),
+                         static_cast<uint32_t>(found->agents.size() - 1)};
+    }
+
+    BTAgent& agent(BTAgentId id) noexcept
+    {
+        return _groups[id.group].agents[id.index];
+    }
+
+    // Status returned by the last tick of the agent.
+    BTStatus status(BTAgentId id) const noexcept
+    {
+        return _groups[id.group].statuses[id.index];
+    }
+
+    size_t agentCount() const noexcept
+    {
+        size_t count = 0;
+
+        for (auto& group : _groups)
+            count += group.agents.size();
+
+        return count;
+    }
+
+    size_t groupCount() const noexcept
+    {
+        return _groups.size();
+    }
+
+    // Ticks every agent on the calling thread. Returns one result per
+    // tree, in the order the trees were first added. Suspended agents
+    // that are not ready cost a check each.
+    const std::vector<BTBatchResult>& tick(BTClock::time_point now =
+                                               BTClock::now())
+    {
+        _results.assign(_groups.size(), BTBatchResult{});
+
+        for (size_t i = 0; i < _groups.size(); ++i)
+        {
+            auto& group      = _groups[i];
+            _results[i].tree = group.tree.get();
+
+            for (size_t j = 0; j < group.agents.size(); ++j)
+                tickAgent(group, j, now, _results[i]);
+        }
+
+        return _results;
+    }
+
+    // Ticks every agent on pool in chunks of at most chunkSize agents of
+    // the same tree, with the calling thread taking chunks as well. Idle
+    // workers steal the jobs that claim chunks, so uneven trees balance
+    // out. Rethrows the first exception an agent threw, after every chunk
+    // finished. Custom nodes and agent data shared between agents must be
+    // safe to use concurrently.
+    const std::vector<BTBatchResult>& tick(
+        ThreadPool&         pool,
+        size_t              chunkSize,
+        BTClock::time_point now = BTClock::now())
+    {
+        std::vector<Chunk> chunks;
+        chunkSize   = std::max<size_t>(chunkSize, 1);
+        auto counts = std::make_unique<std::atomic<size_t>[]>(
+            _groups.size() * countsPerGroup);
+
+        for (size_t i = 0; i < _groups.size(); ++i)
+            for (size_t first = 0; first < _groups[i].agents.size();
+                 first += chunkSize)
+                chunks.push_back(
+                    Chunk{static_cast<uint32_t>(i),
+                          static_cast<uint32_t>(first),
+                          static_cast<uint32_t>(std::min(
+                              first + chunkSize, _groups[i].agents.size()))});
+
+        pool.parallelFor(
+            chunks.size(),
+            1,
+            [this, &chunks, &counts, now](size_t first, size_t last)
+            {
+                for (auto index = first; index < last; ++index)
+                {
+                    auto&         chunk = chunks[index];
+                    auto&         group = _groups[chunk.group];
+                    BTBatchResult result{};
+
+                    for (auto i = chunk.first; i < chunk.last; ++i)
+                        tickAgent(group, i, now, result);
+
+                    auto groupCounts = &counts[chunk.group * countsPerGroup];
+                    groupCounts[0].fetch_add(result.success,
+                                             std::memory_order_relaxed);
+                    groupCounts[1].fetch_add(result.failure,
+                                             std::memory_order_relaxed);
+                    groupCounts[2].fetch_add(result.running,
+                                             std::memory_order_relaxed);
+                    groupCounts[3].fetch_add(result.suspended,
+                                             std::memory_order_relaxed);
+                }
+            });
+
+        _results.assign(_groups.size(), BTBatchResult{});
+
+        for (size_t i = 0; i < _groups.size(); ++i)
+        {
+            auto groupCounts = &counts[i * countsPerGroup];
+            _results[i]      = BTBatchResult{_groups[i].tree.get(),
+                                             groupCounts[0].load(),
+                                             groupCounts[1].load(),
+                                             groupCounts[2].load(),
+                                             groupCounts[3].load()};
+        }
+
+        return _results;
+    }
+
+private:
+    static constexpr size_t countsPerGroup = 4;
+
+    static void tickAgent(Group&              group,
+                          size_t              index,
+                          BTClock::time_point now,
+                          BTBatchResult&      result)
+    {
+        auto& agent = group.agents[index];
+        auto status = group.statuses[index] = agent.tick(now);
+
+        if (agent.isSuspended())
+            ++result.suspended;
+
+        switch (status)
+        {
+        case BTStatus::success:
+            ++result.success;
+            break;
+
+        case BTStatus::failure:
+            ++result.failure;
+            break;
+
+        case BTStatus::running:
+            ++result.running;
+            break;
+        }
+    }
+};
+
+}
@@ -0,0 +1,579 @@
+#pragma once
+
+#include "behaviourtree.hpp"
+#include "blackboard.hpp"
+#include "btcoroutine.hpp"
+#include "../smallvector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <typeinfo>
+#include <vector>
+
+namespace cu::ai
+{
+
+// A BehaviourTree compiled into one array of node records. The children of
+// a node are stored next to each other and referenced by index, so a tick
+// is a loop over the array instead of virtual calls through heap nodes.
+//
+// Built-in nodes are copied, including their action delegates. Custom
+// nodes, subclasses of the built-in ones included, are ticked through a
+// pointer into the source tree, which then has to outlive the compiled
+// one. Ticking gives the same results as ticking the source tree would.
+//
+// The tree keeps the progress of its control nodes for tick(). To share
+// one tree between many agents, hold it in a shared_ptr and give every
+// agent a BTAgent with its own progress instead, which includes the runs
+// of coroutine actions. Custom nodes keep their own state and are shared
+// by every agent. A blackboard layout given to
+// the tree is instantiated for every agent, see BTAgent::blackboard().
+class FlatBehaviourTree
+{
+    friend BTAgent;
+
+public:
+    static constexpr uint32_t noParent = UINT32_MAX;
+
+    struct Node
+    {
+        BTNodeKind kind{};
+        BTTickMode tickMode{};
+        uint32_t   parent{noParent};
+        uint32_t   firstChild{};
+        uint32_t   childCount{};
+
+        // Cursor of control nodes, index of the callable or custom node of
+        // leaves.
+        uint32_t data{};
+    };
+
+private:
+    std::vector<Node>                            _nodes{};
+    std::vector<Delegate<BTStatus(void)>>        _actions{};
+    std::vector<Delegate<BTStatus(BTAgent&)>>    _agentActions{};
+    std::vector<Delegate<BTCoroutine(BTAgent&)>> _coroutineActions{};
+    std::vector<BTNode*>                         _customs{};
+    std::vector<uint32_t>                        _cursors{};
+    std::shared_ptr<const BlackboardLayout>      _blackboardLayout{};
+
+public:
+    // Nodes are laid out breadth first, so siblings are adjacent.
+    explicit FlatBehaviourTree(
+        BehaviourTree&                          tree,
+        std::shared_ptr<const BlackboardLayout> blackboardLayout = nullptr)
+        : _blackboardLayout{std::move(blackboardLayout)}
+    {
+        std::vector<BTNode*> sources{&tree};
+        _nodes.emplace_back();
+
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            auto source     = sources[i];
+            auto kind       = compiledKind(*source);
+            _nodes[i].kind  = kind;
+            auto firstChild = static_cast<uint32_t>(sources.size());
+
+            switch (kind)
+            {
+            case BTNodeKind::tree:
+                if (auto root = static_cast<BehaviourTree*>(source)->root())
+                    sources.push_back(root);
+
+                break;
+
+            case BTNodeKind::fallback:
+            case BTNodeKind::sequence:
+                _nodes[i].data     = static_cast<uint32_t>(_cursors.size());
+                _nodes[i].tickMode =
+                    static_cast<BTControlNode*>(source)->tickMode();
+                _cursors.push_back(0);
+
+                for (auto& child :
+                     static_cast<BTControlNode*>(source)->children())
+                    sources.push_back(child.get());
+
+                break;
+
+            case BTNodeKind::action:
+                _nodes[i].data = static_cast<uint32_t>(_actions.size());
+                _actions.push_back(static_cast<BTAction*>(source)->action());
+                break;
+
+            case BTNodeKind::agentAction:
+                _nodes[i].data = static_cast<uint32_t>(_agentActions.size());
+                _agentActions.push_back(
+                    static_cast<BTAgentAction*>(source)->action());
+                break;
+
+            case BTNodeKind::coroutineAction:
+                _nodes[i].data =
+                    static_cast<uint32_t>(_coroutineActions.size());
+                _coroutineActions.push_back(
+                    static_cast<BTCoroutineAction*>(source)->body());
+                break;
+
+            case BTNodeKind::custom:
+                _nodes[i].data = static_cast<uint32_t>(_customs.size());
+                _customs.push_back(source);
+                break;
+            }
+
+            _nodes[i].firstChild = firstChild;
+            _nodes[i].childCount =
+                static_cast<uint32_t>(sources.size()) - firstChild;
+
+            for (auto child = firstChild; child < sources.size(); ++child)
+                _nodes.push_back(Node{.parent = static_cast<uint32_t>(i)});
+        }
+    }
+
+    size_t nodeCount() const noexcept
+    {
+        return _nodes.size();
+    }
+
+    const Node& node(size_t index) const noexcept
+    {
+        return _nodes[index];
+    }
+
+    const std::shared_ptr<const BlackboardLayout>&
+    blackboardLayout() const noexcept
+    {
+        return _blackboardLayout;
+    }
+
+    // Number of control nodes, which is what a BTAgent keeps per tree.
+    size_t cursorCount() const noexcept
+    {
+        return _cursors.size();
+    }
+
+    // Number of coroutine actions, a BTAgent keeps a run of each.
+    size_t coroutineCount() const noexcept
+    {
+        return _coroutineActions.size();
+    }
+
+    // Forgets the progress of every control node.
+    void reset() noexcept
+    {
+        std::fill(_cursors.begin(), _cursors.end(), 0);
+    }
+
+    BTStatus tick()
+    {
+        return tick(_cursors.data(), nullptr);
+    }
+
+private:
+    // Ticks with the progress of agent, which runs this tree. Only
+    // BTAgent::tick() calls this, so the two can not be mismatched.
+    BTStatus tick(BTAgent& agent) const;
+
+    BTStatus tickCoroutine(uint32_t index, BTAgent& agent) const;
+
+    // The kind of node if it is exactly one of the built-in classes,
+    // custom otherwise.
+    static BTNodeKind compiledKind(const BTNode& node)
+    {
+        const std::type_info* builtin{};
+
+        switch (node.kind())
+        {
+        case BTNodeKind::tree:
+            builtin = &typeid(BehaviourTree);
+            break;
+
+        case BTNodeKind::fallback:
+            builtin = &typeid(BTFallback);
+            break;
+
+        case BTNodeKind::sequence:
+            builtin = &typeid(BTSequence);
+            break;
+
+        case BTNodeKind::action:
+            builtin = &typeid(BTAction);
+            break;
+
+        case BTNodeKind::agentAction:
+            builtin = &typeid(BTAgentAction);
+            break;
+
+        case BTNodeKind::coroutineAction:
+            builtin = &typeid(BTCoroutineAction);
+            break;
+
+        case BTNodeKind::custom:
+            return BTNodeKind::custom;
+        }
+
+        return typeid(node) == *builtin ? node.kind() : BTNodeKind::custom;
+    }
+
+    // Walks down from the root to the leaf that runs this tick, then
+    // passes its status back up through the control nodes on the way. A
+    // control node that runs to completion and moved on to its next child
+    // walks down again from there.
+    BTStatus tick(uint32_t* cursors, BTAgent* agent) const
+    {
+        uint32_t index  = 0;
+        auto     status = descend(index, cursors, agent);
+
+        while (noParent != _nodes[index].parent)
+        {
+            index            = _nodes[index].parent;
+            const auto& node = _nodes[index];
+            auto childStatus = status;
+            status           = resume(node, cursors, childStatus);
+
+            if (BTStatus::running == status &&
+                BTStatus::running != childStatus &&
+                BTTickMode::runToCompletion == node.tickMode)
+                status = descend(index, cursors, agent);
+        }
+
+        return status;
+    }
+
+    BTStatus descend(uint32_t& index, uint32_t* cursors, BTAgent* agent) const
+    {
+        while (true)
+        {
+            const auto& node = _nodes[index];
+
+            switch (node.kind)
+            {
+            case BTNodeKind::tree:
+                if (0 == node.childCount)
+                    return BTStatus::failure;
+
+                index = node.firstChild;
+                break;
+
+            case BTNodeKind::fallback:
+            case BTNodeKind::sequence:
+                if (cursors[node.data] >= node.childCount)
+                {
+                    cursors[node.data] = 0;
+
+                    return BTStatus::failure;
+                }
+
+                index = node.firstChild + cursors[node.data];
+                break;
+
+            case BTNodeKind::action:
+                return _actions[node.data]();
+
+            case BTNodeKind::agentAction:
+                if (nullptr == agent)
+                    throw std::runtime_error(
+                        "BTAgentAction needs an agent to tick.");
+
+                return _agentActions[node.data](*agent);
+
+            case BTNodeKind::coroutineAction:
+                if (nullptr == agent)
+                    throw std::runtime_error(
+                        "BTCoroutineAction needs an agent to tick.");
+
+                return tickCoroutine(node.data, *agent);
+
+            case BTNodeKind::custom:
+                return _customs[node.data]->tick();
+            }
+        }
+    }
+
+    // Mirrors BTFallback::tick() and BTSequence::tick() once the current
+    // child returned status.
+    static BTStatus resume(const Node& node,
+                           uint32_t*   cursors,
+                           BTStatus    status) noexcept
+    {
+        if (BTNodeKind::fallback == node.kind)
+        {
+            auto& cursor = cursors[node.data];
+
+            if (BTStatus::success == status)
+            {
+                cursor = 0;
+
+                return BTStatus::success;
+            }
+
+            if (BTStatus::failure == status && ++cursor >= node.childCount)
+            {
+                cursor = 0;
+
+                return BTStatus::failure;
+            }
+
+            return BTStatus::running;
+        }
+
+        if (BTNodeKind::sequence == node.kind)
+        {
+            auto& cursor = cursors[node.data];
+
+            if (BTStatus::failure == status)
+            {
+                cursor = 0;
+
+                return BTStatus::failure;
+            }
+
+            if (BTStatus::success == status && ++cursor >= node.childCount)
+            {
+                cursor = 0;
+
+                return BTStatus::success;
+            }
+
+            return BTStatus::running;
+        }
+
+        return status;
+    }
+};
+
+// Progress of one agent through a shared FlatBehaviourTree: a cursor per
+// control node, stored inline for small trees, a run per coroutine action,
+// the blackboard of the agent and a pointer to its data for its
+// BTAgentAction nodes.
+//
+// An action that returns running can suspend the agent until a time, a
+// write to a blackboard key through Blackboard::set() or a signal. Ticks
+// of a suspended agent return running without entering the tree until
+// one of its wake conditions is met. A sleeping coroutine action suspends
+// the agent until its wake time.
+//
+// Coroutine bodies refer to the agent they run for, so agents can not be
+// copied, and a moved agent starts its coroutine actions over.
+class BTAgent
+{
+    friend FlatBehaviourTree;
+
+    class CoroutineRuns
+    {
+        std::vector<BTCoroutine> _runs{};
+
+    public:
+        CoroutineRuns() = default;
+
+        explicit CoroutineRuns(size_t count)
+            : _runs(count)
+        {
+        }
+
+        CoroutineRuns(CoroutineRuns&& other) noexcept
+            : _runs{std::move(other._runs)}
+        {
+            reset();
+        }
+
+        CoroutineRuns& operator=(CoroutineRuns&& other) noexcept
+        {
+            _runs = std::move(other._runs);
+            reset();
+
+            return *this;
+        }
+
+        CoroutineRuns(const CoroutineRuns& other)            = delete;
+        CoroutineRuns& operator=(const CoroutineRuns& other) = delete;
+
+        BTCoroutine& operator[](size_t index) noexcept
+        {
+            return _runs[index];
+        }
+
+        void reset() noexcept
+        {
+            for (auto& run : _runs)
+                run = BTCoroutine{};
+        }
+    };
+
+    std::shared_ptr<const FlatBehaviourTree> _tree{};
+    SmallVector<uint32_t, 8>                 _cursors{};
+    CoroutineRuns                            _coroutines{};
+    Blackboard                               _blackboard{};
+    void*                                    _userData{};
+    BTClock::time_point                      _now{};
+    BTClock::time_point                      _wakeTime{};
+    bool                                     _suspended{};
+    bool                                     _waitsForSignal{};
+    bool                                     _signalled{};
+
+public:
+    explicit BTAgent(std::shared_ptr<const FlatBehaviourTree> tree,
+                     void* userData = nullptr)
+        : _tree{std::move(tree)}
+        , _coroutines{_tree->coroutineCount()}
+        , _blackboard{_tree->blackboardLayout()}
+        , _userData{userData}
+    {
+        for (size_t i = 0; i < _tree->cursorCount(); ++i)
+            _cursors.push_back(0);
+    }
+
+    const FlatBehaviourTree& tree() const noexcept
+    {
+        return *_tree;
+    }
+
+    // Empty unless the tree was compiled with a blackboard layout.
+    Blackboard& blackboard() noexcept
+    {
+        return _blackboard;
+    }
+
+    const Blackboard& blackboard() const noexcept
+    {
+        return _blackboard;
+    }
+
+    template<typename T>
+    T* userData() const noexcept
+    {
+        return static_cast<T*>(_userData);
+    }
+
+    void setUserData(void* userData) noexcept
+    {
+        _userData = userData;
+    }
+
+    // Forgets the progress through the tree, including coroutine actions,
+    // and any wake conditions.
+    void reset() noexcept
+    {
+        std::fill(_cursors.begin(), _cursors.end(), 0);
+        _coroutines.reset();
+        wake();
+    }
+
+    // Time of the tick in progress, or of the last one.
+    BTClock::time_point now() const noexcept
+    {
+        return _now;
+    }
+
+    bool isSuspended() const noexcept
+    {
+        return _suspended;
+    }
+
+    // Wake conditions, to be registered by an action of the tick in
+    // progress that then returns running. The agent wakes on the first
+    // condition met; a later key replaces an earlier one.
+    void sleepUntil(BTClock::time_point time) noexcept
+    {
+        _wakeTime  = _suspended ? std::min(_wakeTime, time) : time;
+        _suspended = true;
+    }
+
+    void sleepFor(BTClock::duration duration) noexcept
+    {
+        sleepUntil(_now + duration);
+    }
+
+    template<typename T>
+    void waitFor(BlackboardKey<T> key) noexcept
+    {
+        suspend();
+        _blackboard.watch(key);
+    }
+
+    void waitForSignal() noexcept
+    {
+        suspend();
+        _waitsForSignal = true;
+    }
+
+    // Wakes the agent if it waits for a signal. Must not race with a tick
+    // of the agent.
+    void signal() noexcept
+    {
+        _signalled = _waitsForSignal;
+    }
+
+    bool isReady(BTClock::time_point now) const noexcept
+    {
+        return !_suspended || now >= _wakeTime || _signalled ||
+               _blackboard.watchedChanged();
+    }
+
+    BTStatus tick(BTClock::time_point now = BTClock::now())
+    {
+        if (!isReady(now))
+            return BTStatus::running;
+
+        wake();
+        _now        = now;
+        auto status = _tree->tick(*this);
+
+        if (BTStatus::running != status)
+            wake();
+
+        return status;
+    }
+
+private:
+    void suspend() noexcept
+    {
+        if (!_suspended)
+            _wakeTime = BTClock::time_point::max();
+
+        _suspended = true;
+    }
+
+    void wake() noexcept
+    {
+        _suspended      = false;
+        _waitsForSignal = false;
+        _signalled      = false;
+        _blackboard.unwatch();
+    }
+};
+
+inline BTStatus
+FlatBehaviourTree::tick(BTAgent& agent) const
+{
+    return tick(agent._cursors.data(), &agent);
+}
+
+inline BTStatus
+FlatBehaviourTree::tickCoroutine(uint32_t index, BTAgent& agent) const
+{
+    auto& run = agent._coroutines[index];
+
+    if (!run)
+        run = _coroutineActions[index](agent);
+
+    BTStatus status;
+
+    try
+    {
+        status = run.resume(agent._now);
+    }
+    catch (...)
+    {
+        run = BTCoroutine{};
+        throw;
+    }
+
+    if (BTStatus::running != status)
+        run = BTCoroutine{};
+    else if (run.wakeTime() > agent._now)
+        agent.sleepUntil(run.wakeTime());
+
+    return status;
+}
+
+}
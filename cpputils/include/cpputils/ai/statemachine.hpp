@@ -1,10 +1,10 @@
 #pragma once
 
+#include "../delegate.hpp"
 #include <vector>
 #include <type_traits>
 #include <concepts>
 #include <memory>
-#include <functional>
 #include <mutex>
 
 namespace cu::ai
@@ -118,21 +118,21 @@ public:
 
 class FSMActionState : public FSMState
 {
-    std::function<FSMEvent&(void)>       _tickFunc;
-    std::function<void(const FSMEvent&)> _onActivatedCallback;
+    Delegate<FSMEvent&(void)>       _tickFunc;
+    Delegate<void(const FSMEvent&)> _onActivatedCallback;
 
 public:
     FSMEvent done;
 
-    FSMActionState(std::function<FSMEvent&(void)> tickFunc) noexcept
+    FSMActionState(Delegate<FSMEvent&(void)> tickFunc) noexcept
         : _tickFunc{std::move(tickFunc)}
         , _onActivatedCallback{[](auto) {}}
     {
     }
 
     FSMActionState(
-        std::function<FSMEvent&(void)>       tickFunc,
-        std::function<void(const FSMEvent&)> onActivatedCallback) noexcept
+        Delegate<FSMEvent&(void)>       tickFunc,
+        Delegate<void(const FSMEvent&)> onActivatedCallback) noexcept
         : _tickFunc{std::move(tickFunc)}
         , _onActivatedCallback{std::move(onActivatedCallback)}
     {
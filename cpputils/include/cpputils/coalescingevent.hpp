@@ -0,0 +1,218 @@
+#pragma once
+
+#include "event.hpp"
+#include <chrono>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace cu
+{
+
+// Collects events between flushes and delivers at most one per key.
+// Without a key every post collapses into a single pending event. A later
+// post replaces the pending one unless a merge function is given, which
+// then folds the incoming event into the pending one.
+//
+// Listeners see events in the order their keys were first posted since
+// the previous flush. Events posted while flushing wait for the next one.
+template<typename TEvent, typename TKey = void>
+class CoalescingEventHandler
+{
+#pragma region ____________________________ Types ______________________________
+
+public:
+    using Clock    = std::chrono::steady_clock;
+    using Merge    = Delegate<void(TEvent& pending, const TEvent& incoming)>;
+    using KeyType  = std::conditional_t<std::is_void_v<TKey>, bool, TKey>;
+    using KeyOf    = Delegate<KeyType(const TEvent&)>;
+    using Listener = EventListener<const TEvent&>;
+
+private:
+    static constexpr bool keyed = !std::is_void_v<TKey>;
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    // window limits how often poll() delivers, zero delivers on every poll.
+    explicit CoalescingEventHandler(Merge           merge  = nullptr,
+                                    Clock::duration window = {})
+        requires(!keyed)
+        : _merge{std::move(merge)}
+        , _window{window}
+    {
+    }
+
+    explicit CoalescingEventHandler(KeyOf           keyOf,
+                                    Merge           merge  = nullptr,
+                                    Clock::duration window = {})
+        requires keyed
+        : _keyOf{std::move(keyOf)}
+        , _merge{std::move(merge)}
+        , _window{window}
+    {
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    void operator+=(Listener& listener)
+    {
+        _handler += listener;
+    }
+
+    void operator-=(Listener& listener)
+    {
+        _handler -= listener;
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    EventConnection subscribe(Listener& listener)
+    {
+        return _handler.subscribe(listener);
+    }
+
+    void unsubscribe(EventConnection connection)
+    {
+        _handler.unsubscribe(connection);
+    }
+
+    size_t listenerCount() const noexcept
+    {
+        return _handler.listenerCount();
+    }
+
+    size_t pendingCount() const noexcept
+    {
+        return _pending.size();
+    }
+
+    // Number of posts that were folded into an already pending event.
+    size_t coalescedCount() const noexcept
+    {
+        return _coalescedCount;
+    }
+
+    void post(const TEvent& event)
+    {
+        if constexpr (keyed)
+        {
+            auto [found, added] =
+                _pendingIndex.try_emplace(_keyOf(event), _pending.size());
+
+            if (!added)
+            {
+                coalesce(_pending[found->second], event);
+
+                return;
+            }
+
+            try
+            {
+                _pending.push_back(event);
+            }
+            catch (...)
+            {
+                _pendingIndex.erase(found);
+                throw;
+            }
+        }
+        else
+        {
+            if (!_pending.empty())
+            {
+                coalesce(_pending.front(), event);
+
+                return;
+            }
+
+            _pending.push_back(event);
+        }
+    }
+
+    // Delivers every pending event and returns how many were delivered.
+    // If a listener throws, the events not delivered yet are dropped.
+    size_t flush()
+    {
+        if (_flushing || _pending.empty())
+            return 0;
+
+        struct FlushGuard
+        {
+            CoalescingEventHandler<TEvent, TKey>& handler;
+
+            ~FlushGuard()
+            {
+                handler._delivering.clear();
+                handler._flushing = false;
+            }
+        };
+
+        _flushing = true;
+        FlushGuard guard{*this};
+        _delivering.swap(_pending);
+
+        if constexpr (keyed)
+            _pendingIndex.clear();
+
+        // Posts from listeners land in the now empty _pending.
+        for (auto& event : _delivering)
+            _handler.emitMoving(std::move(event));
+
+        _lastFlushTime = Clock::now();
+
+        return _delivering.size();
+    }
+
+    // Flushes if at least the configured window passed since the last
+    // flush, for sources that are polled every frame.
+    size_t poll(Clock::time_point now = Clock::now())
+    {
+        if (now - _lastFlushTime < _window)
+            return 0;
+
+        return flush();
+    }
+
+private:
+    void coalesce(TEvent& pending, const TEvent& incoming)
+    {
+        if (_merge)
+            _merge(pending, incoming);
+        else
+            pending = incoming;
+
+        ++_coalescedCount;
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    using PendingIndex =
+        std::conditional_t<keyed, std::unordered_map<KeyType, size_t>, bool>;
+
+    KeyOf                       _keyOf{};
+    Merge                       _merge{};
+    Clock::duration             _window{};
+    Clock::time_point           _lastFlushTime{};
+    std::vector<TEvent>         _pending{};
+    std::vector<TEvent>         _delivering{};
+    PendingIndex                _pendingIndex{};
+    size_t                      _coalescedCount{};
+    bool                        _flushing{};
+    EventHandler<const TEvent&> _handler{};
+
+#pragma endregion
+};
+
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+#include "delegate.hpp"
+#include "event.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cu
+{
+
+// An event that can be invoked from any number of threads at once.
+// Invoking never locks: it reads an immutable listener snapshot. Changing
+// the listeners copies the snapshot, publishes the copy and frees the old
+// one after every invocation that could still see it has finished.
+template<typename... TArgs>
+class ConcurrentEventHandler
+{
+#pragma region ____________________________ Types ______________________________
+
+public:
+    using SubscriptionId = uint64_t;
+
+private:
+    struct Entry
+    {
+        SubscriptionId                     id;
+        Delegate<void(EventArg<TArgs>...)> callback;
+    };
+
+    struct Snapshot
+    {
+        std::vector<Entry> entries;
+    };
+
+    struct alignas(64) ReaderCounter
+    {
+        std::atomic<size_t> value{};
+    };
+
+    // Registers an invocation in a reader counter and in the stack of
+    // invocations running on this thread, which can span several handlers.
+    class ReadGuard
+    {
+        static inline thread_local const ReadGuard* _innermost{};
+
+        std::atomic<size_t>&                    _counter;
+        const ConcurrentEventHandler<TArgs...>* _handler;
+        const ReadGuard*                        _outer;
+
+    public:
+        ReadGuard(std::atomic<size_t>&                    counter,
+                  const ConcurrentEventHandler<TArgs...>* handler)
+            : _counter{counter}
+            , _handler{handler}
+            , _outer{_innermost}
+        {
+            _counter.fetch_add(1);
+            _innermost = this;
+        }
+
+        ~ReadGuard()
+        {
+            _innermost = _outer;
+            _counter.fetch_sub(1, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard& other)            = delete;
+        ReadGuard& operator=(const ReadGuard& other) = delete;
+
+        static bool isInvoking(
+            const ConcurrentEventHandler<TArgs...>* handler) noexcept
+        {
+            auto guard = _innermost;
+
+            while (nullptr != guard && handler != guard->_handler)
+                guard = guard->_outer;
+
+            return nullptr != guard;
+        }
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    ConcurrentEventHandler() = default;
+
+    // Must not run concurrently with invocations.
+    ~ConcurrentEventHandler()
+    {
+        delete _snapshot.load();
+
+        for (auto snapshot : _retired)
+            delete snapshot;
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    ConcurrentEventHandler(ConcurrentEventHandler<TArgs...>&& other) = delete;
+    ConcurrentEventHandler<TArgs...>& operator=(
+        ConcurrentEventHandler<TArgs...>&& other) = delete;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    ConcurrentEventHandler(const ConcurrentEventHandler<TArgs...>& other) =
+        delete;
+    ConcurrentEventHandler<TArgs...>& operator=(
+        const ConcurrentEventHandler<TArgs...>& other) = delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    void operator()(EventArg<TArgs>... args) const
+    {
+        // The epoch picks which reader counter this invocation registers
+        // in, so a writer can wait for exactly the invocations that started
+        // before it published.
+        auto      epoch = _epoch.load();
+        ReadGuard guard{_readers[epoch & 1][stripe()].value, this};
+
+        auto snapshot = _snapshot.load();
+
+        if (nullptr == snapshot)
+            return;
+
+        for (auto& entry : snapshot->entries)
+            entry.callback(args...);
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    // Listeners are copied into every new snapshot, so their callables
+    // must be copyable.
+    SubscriptionId subscribe(Delegate<void(EventArg<TArgs>...)> callback)
+    {
+        std::lock_guard lock{_writeMutex};
+
+        auto current = _snapshot.load();
+        auto next    = std::make_unique<Snapshot>();
+
+        if (nullptr != current)
+            next->entries = current->entries;
+
+        auto id = _lastId + 1;
+        next->entries.push_back({id, std::move(callback)});
+        publish(std::move(next));
+        _lastId = id;
+
+        return id;
+    }
+
+    // Once this returns, the callback is no longer running on any thread,
+    // unless it was called from inside an invocation of this handler.
+    bool unsubscribe(SubscriptionId id)
+    {
+        std::lock_guard lock{_writeMutex};
+
+        auto current = _snapshot.load();
+
+        if (nullptr == current)
+            return false;
+
+        auto next = std::make_unique<Snapshot>();
+        next->entries.reserve(current->entries.size());
+
+        for (auto& entry : current->entries)
+            if (entry.id != id)
+                next->entries.push_back(entry);
+
+        if (next->entries.size() == current->entries.size())
+            return false;
+
+        publish(std::move(next));
+
+        return true;
+    }
+
+    size_t listenerCount() const noexcept
+    {
+        auto snapshot = _snapshot.load();
+
+        return nullptr == snapshot ? 0 : snapshot->entries.size();
+    }
+
+    // Waits until every invocation that started before this call returned.
+    void synchronize()
+    {
+        std::lock_guard lock{_writeMutex};
+
+        waitForReaders();
+    }
+
+private:
+    static size_t stripe() noexcept
+    {
+        static thread_local size_t index =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+            readerStripes;
+
+        return index;
+    }
+
+    void publish(std::unique_ptr<Snapshot> next)
+    {
+        // Reserving first keeps the swap and the retiring from failing
+        // halfway.
+        _retired.reserve(_retired.size() + 1);
+
+        auto previous = _snapshot.exchange(next.release());
+
+        if (nullptr != previous)
+            _retired.push_back(previous);
+
+        // Waiting here from inside a listener of this handler would wait
+        // for ourselves, so the old snapshots are freed by a later writer
+        // instead.
+        if (ReadGuard::isInvoking(this))
+            return;
+
+        waitForReaders();
+
+        for (auto snapshot : _retired)
+            delete snapshot;
+
+        _retired.clear();
+    }
+
+    // Flipping twice makes sure readers that registered under either
+    // parity before the snapshot was swapped have left. New readers always
+    // register under the current parity and see the new snapshot.
+    void waitForReaders() const
+    {
+        for (int phase = 0; phase < 2; ++phase)
+        {
+            auto  epoch   = _epoch.fetch_add(1);
+            auto& drained = _readers[epoch & 1];
+
+            // A reader can be preempted while registered. Yielding keeps
+            // the CPU with the other readers under oversubscription, so
+            // fall back to sleeping after a few attempts.
+            for (auto& counter : drained)
+                for (int spins = 0; 0 != counter.value.load(); ++spins)
+                    if (spins < 64)
+                        std::this_thread::yield();
+                    else
+                        std::this_thread::sleep_for(
+                            std::chrono::microseconds{50});
+        }
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    static constexpr size_t readerStripes = 16;
+
+    std::atomic<Snapshot*>        _snapshot{};
+    mutable std::atomic<uint64_t> _epoch{};
+    mutable ReaderCounter         _readers[2][readerStripes]{};
+    std::mutex                    _writeMutex{};
+    std::vector<Snapshot*>        _retired{};
+    SubscriptionId                _lastId{};
+
+#pragma endregion
+};
+
+}
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cu
+{
+
+// Large enough for a std::function or a lambda capturing a few pointers.
+inline constexpr size_t defaultDelegateCapacity = 6 * sizeof(void*);
+
+template<typename TSignature, size_t TCapacity = defaultDelegateCapacity>
+class Delegate;
+
+// Like std::function, but a callable that fits lives inside the delegate.
+// A callable that is too large, over-aligned or may throw when moved is
+// kept on the heap instead; raise TCapacity to keep it inline.
+template<typename TReturn, typename... TArgs, size_t TCapacity>
+class Delegate<TReturn(TArgs...), TCapacity>
+{
+#pragma region ____________________________ Types ______________________________
+
+private:
+    struct Operations
+    {
+        TReturn (*invoke)(void*, TArgs&&...);
+        void (*copy)(void*, const void*);
+        void (*move)(void*, void*) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<typename TCallable>
+    static constexpr Operations operationsFor{
+        [](void* callable, TArgs&&... args) -> TReturn
+        {
+            return std::invoke(*static_cast<TCallable*>(callable),
+                               std::forward<TArgs>(args)...);
+        },
+        [](void* destination, const void* source)
+        {
+            ::new (destination)
+                TCallable(*static_cast<const TCallable*>(source));
+        },
+        [](void* destination, void* source) noexcept
+        {
+            ::new (destination)
+                TCallable(std::move(*static_cast<TCallable*>(source)));
+            static_cast<TCallable*>(source)->~TCallable();
+        },
+        [](void* callable) noexcept
+        { static_cast<TCallable*>(callable)->~TCallable(); }};
+
+    // The storage only holds a pointer to the callable.
+    template<typename TCallable>
+    static constexpr Operations heapOperationsFor{
+        [](void* callable, TArgs&&... args) -> TReturn
+        {
+            return std::invoke(**static_cast<TCallable**>(callable),
+                               std::forward<TArgs>(args)...);
+        },
+        [](void* destination, const void* source)
+        {
+            ::new (destination) TCallable*(
+                new TCallable(**static_cast<TCallable* const*>(source)));
+        },
+        [](void* destination, void* source) noexcept
+        {
+            ::new (destination)
+                TCallable*(*static_cast<TCallable**>(source));
+        },
+        [](void* callable) noexcept
+        { delete *static_cast<TCallable**>(callable); }};
+
+    template<typename TCallable>
+    static constexpr bool fitsInline =
+        sizeof(TCallable) <= TCapacity &&
+        alignof(TCallable) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<TCallable>;
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    Delegate() = default;
+
+    Delegate(std::nullptr_t) noexcept
+    {
+    }
+
+    // Delegates are copyable, so move-only callables are rejected here
+    // instead of failing when the delegate is copied.
+    template<typename TCallable>
+        requires(!std::is_same_v<std::decay_t<TCallable>,
+                                 Delegate<TReturn(TArgs...), TCapacity>> &&
+                 std::is_invocable_r_v<TReturn,
+                                       std::decay_t<TCallable>&,
+                                       TArgs...> &&
+                 std::is_copy_constructible_v<std::decay_t<TCallable>>)
+    Delegate(TCallable&& callable)
+    {
+        using T = std::decay_t<TCallable>;
+
+        static_assert(sizeof(T*) <= TCapacity,
+                      "Delegate must be able to hold at least a pointer.");
+
+        // A function passed by name decays to a pointer but can not be
+        // null.
+        if constexpr (std::is_pointer_v<std::remove_reference_t<TCallable>> ||
+                      std::is_member_pointer_v<T>)
+        {
+            if (nullptr == callable)
+                return;
+        }
+
+        if constexpr (fitsInline<T>)
+        {
+            ::new (static_cast<void*>(_storage))
+                T(std::forward<TCallable>(callable));
+            _operations = &operationsFor<T>;
+        }
+        else
+        {
+            ::new (static_cast<void*>(_storage))
+                T*(new T(std::forward<TCallable>(callable)));
+            _operations = &heapOperationsFor<T>;
+        }
+    }
+
+    ~Delegate()
+    {
+        reset();
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    Delegate(Delegate<TReturn(TArgs...), TCapacity>&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    Delegate<TReturn(TArgs...), TCapacity>& operator=(
+        Delegate<TReturn(TArgs...), TCapacity>&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        reset();
+        moveFrom(other);
+
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    Delegate(const Delegate<TReturn(TArgs...), TCapacity>& other)
+    {
+        copyFrom(other);
+    }
+
+    Delegate<TReturn(TArgs...), TCapacity>& operator=(
+        const Delegate<TReturn(TArgs...), TCapacity>& other)
+    {
+        if (this == &other)
+            return *this;
+
+        reset();
+        copyFrom(other);
+
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    TReturn operator()(TArgs... args) const
+    {
+        if (nullptr == _operations)
+            throw std::bad_function_call();
+
+        return _operations->invoke(_storage, std::forward<TArgs>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return nullptr != _operations;
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    void reset() noexcept
+    {
+        if (nullptr == _operations)
+            return;
+
+        _operations->destroy(_storage);
+        _operations = nullptr;
+    }
+
+private:
+    void moveFrom(Delegate<TReturn(TArgs...), TCapacity>& other) noexcept
+    {
+        if (nullptr == other._operations)
+            return;
+
+        other._operations->move(_storage, other._storage);
+        _operations       = other._operations;
+        other._operations = nullptr;
+    }
+
+    void copyFrom(const Delegate<TReturn(TArgs...), TCapacity>& other)
+    {
+        if (nullptr == other._operations)
+            return;
+
+        other._operations->copy(_storage, other._storage);
+        _operations = other._operations;
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    const Operations* _operations{};
+
+    alignas(std::max_align_t) mutable std::byte _storage[TCapacity];
+
+#pragma endregion
+};
+
+template<typename TSignature>
+class FunctionRef;
+
+// Borrows a callable without copying or owning it, for parameters that are
+// only called before the function returns.
+template<typename TReturn, typename... TArgs>
+class FunctionRef<TReturn(TArgs...)>
+{
+#pragma region _________________________ Constructors __________________________
+
+public:
+    template<typename TCallable>
+        requires(!std::is_same_v<std::remove_cvref_t<TCallable>,
+                                 FunctionRef<TReturn(TArgs...)>> &&
+                 std::is_object_v<std::remove_reference_t<TCallable>> &&
+                 std::is_invocable_r_v<TReturn, TCallable&, TArgs...>)
+    FunctionRef(TCallable&& callable) noexcept
+        : _callable{const_cast<void*>(
+              static_cast<const void*>(std::addressof(callable)))}
+        , _invoke{[](void* callable, TArgs&&... args) -> TReturn
+                  {
+                      return std::invoke(
+                          *static_cast<std::remove_reference_t<TCallable>*>(
+                              callable),
+                          std::forward<TArgs>(args)...);
+                  }}
+    {
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    TReturn operator()(TArgs... args) const
+    {
+        return _invoke(_callable, std::forward<TArgs>(args)...);
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    void* _callable;
+    TReturn (*_invoke)(void*, TArgs&&...);
+
+#pragma endregion
+};
+
+}
@@ -1,7 +1,18 @@
 #pragma once
 
-#include <list>
-#include <functional>
+#include "delegate.hpp"
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include <algorithm>
+#include <span>
+#include <tuple>
+
+#ifdef CU_EVENT_INSTRUMENTATION
+#include <array>
+#include <bit>
+#include <chrono>
+#endif
 
 namespace cu
 {
@@ -9,6 +20,84 @@ namespace cu
 template<typename... TArgs>
 class EventHandler;
 
+// How an event argument is handed to listeners. Small trivially copyable
+// values are passed by value, anything else by const reference so that
+// invoking N listeners does not make N copies. Reference arguments are
+// passed through unchanged.
+template<typename T>
+using EventArg = std::conditional_t<
+    std::is_reference_v<T> ||
+        (std::is_trivially_copyable_v<T> && sizeof(T) <= 2 * sizeof(void*)),
+    T,
+    const T&>;
+
+// Callbacks that take a by-value event argument by mutable reference. They
+// do not bind to EventArg, so each call gets its own copy of the arguments.
+template<typename TCallable, typename... TArgs>
+concept CopyingEventCallback =
+    !std::is_invocable_v<TCallable&, EventArg<TArgs>...> &&
+    std::is_invocable_v<TCallable&, std::remove_cvref_t<TArgs>&...>;
+
+// Identifies one subscription. A handle outlives its subscription safely:
+// once the slot is reused the generation no longer matches.
+struct EventConnection
+{
+    uint32_t index{};
+    uint32_t generation{};
+};
+
+// A pool that EventHandler::invokeParallel() can fan listeners out to,
+// such as cu::ThreadPool. parallelFor(count, chunkSize, fn) calls fn for
+// ranges of indices covering [0, count) and rethrows what fn threw.
+template<typename TPool>
+concept EventWorkerPool =
+    requires(TPool& pool, size_t count, void (*fn)(size_t, size_t)) {
+        pool.parallelFor(count, count, fn);
+    };
+
+#ifdef CU_EVENT_INSTRUMENTATION
+
+// Timings of one listener, or of whole invocations. Bucket i of the
+// histogram counts durations below 2^i nanoseconds that did not fit in
+// bucket i - 1, the last bucket takes everything longer.
+struct EventLatencyStats
+{
+    uint64_t                 count{};
+    uint64_t                 totalNanoseconds{};
+    uint64_t                 maxNanoseconds{};
+    std::array<uint64_t, 40> histogram{};
+
+    void record(uint64_t nanoseconds) noexcept
+    {
+        auto bucket = std::min<size_t>(std::bit_width(nanoseconds),
+                                       histogram.size() - 1);
+
+        ++count;
+        totalNanoseconds += nanoseconds;
+        maxNanoseconds    = std::max(maxNanoseconds, nanoseconds);
+        ++histogram[bucket];
+    }
+};
+
+struct EventListenerStats
+{
+    EventConnection   connection{};
+    EventLatencyStats latency{};
+};
+
+struct EventHandlerStats
+{
+    // Invocations, nested ones included. Their latency only covers
+    // outermost invocations, which already contain the nested ones.
+    uint64_t                        emitCount{};
+    EventLatencyStats               emitLatency{};
+    std::vector<EventListenerStats> listeners{};
+    size_t                          pendingRemovals{};
+    size_t                          peakPendingRemovals{};
+};
+
+#endif
+
 template<typename... TArgs>
 class EventListener
 {
@@ -17,14 +106,31 @@ class EventListener
 public:
     friend EventHandler<TArgs...>;
 
+    // One event of a batch passed to EventHandler::emitBatch().
+    using BatchEvent = std::tuple<std::remove_cvref_t<TArgs>...>;
+
+private:
+    struct Connection
+    {
+        EventHandler<TArgs...>* handler;
+        uint32_t                slot;
+    };
+
 #pragma endregion
 
 #pragma region _________________________ Constructors __________________________
 
 public:
-    EventListener(std::function<void(TArgs...)> callback);
+    EventListener(Delegate<void(EventArg<TArgs>...)> callback);
+
+    template<CopyingEventCallback<TArgs...> TCallable>
+    EventListener(TCallable callback);
+
     ~EventListener();
 
+private:
+    EventListener() = default;
+
 #pragma endregion
 
 #pragma region ________________________ Move Semantics _________________________
@@ -43,11 +149,44 @@ public:
 
 #pragma endregion
 
+#pragma region ____________________________ Static _____________________________
+
+public:
+    // A listener that takes ownership of the arguments. It receives its own
+    // copy, or the arguments themselves when the handler emits with
+    // emitMoving() and no other listener comes after it.
+    static EventListener<TArgs...> consuming(
+        Delegate<void(std::remove_cvref_t<TArgs>&&...)> callback);
+
+    // A listener that receives emitBatch() batches whole. Single events
+    // reach it as a batch of one.
+    static EventListener<TArgs...> batched(
+        Delegate<void(std::span<const BatchEvent>)> callback);
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    // Independent listeners do not touch state shared with other listeners
+    // of the same event, so invokeParallel() may run them concurrently.
+    void setIndependent(bool independent) noexcept;
+    bool isIndependent() const noexcept;
+
+private:
+    void notify(EventArg<TArgs>... args) const;
+    void disconnectAll();
+
+#pragma endregion
+
 #pragma region ____________________________ Fields _____________________________
 
 private:
-    std::function<void(TArgs...)>      _callback;
-    std::list<EventHandler<TArgs...>*> _handlers{};
+    Delegate<void(EventArg<TArgs>...)>              _callback{};
+    Delegate<void(std::remove_cvref_t<TArgs>&&...)> _consumer{};
+    Delegate<void(std::span<const BatchEvent>)>     _batch{};
+    std::vector<Connection>                         _connections{};
+    bool                                            _independent{};
 
 #pragma endregion
 };
@@ -59,6 +198,20 @@ class EventHandler
 
     friend EventListener<TArgs...>;
 
+    // A slot is free while listener is null. connection is the index of
+    // the matching entry in the listener's _connections, which is what
+    // makes unsubscribing O(1) on both sides.
+    struct Slot
+    {
+        EventListener<TArgs...>* listener;
+        uint32_t                 connection;
+        uint32_t                 generation;
+
+#ifdef CU_EVENT_INSTRUMENTATION
+        EventLatencyStats stats{};
+#endif
+    };
+
 #pragma endregion
 
 #pragma region _________________________ Constructors __________________________
@@ -90,17 +243,74 @@ public:
 public:
     void operator+=(EventListener<TArgs...>& listener);
     void operator-=(EventListener<TArgs...>& listener);
-    void operator()(TArgs... args);
+    void operator()(EventArg<TArgs>... args);
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    EventConnection subscribe(EventListener<TArgs...>& listener);
+    void            unsubscribe(EventConnection connection);
+    bool            isConnected(EventConnection connection) const noexcept;
+    size_t          listenerCount() const noexcept;
+
+    // Like operator(), but hands the arguments to the last listener when it
+    // is a consuming one, saving that listener a copy.
+    void emitMoving(std::remove_cvref_t<TArgs>&&... args);
+
+    // Runs the independent listeners on pool in chunks of chunkSize, with
+    // the calling thread taking chunks as well. The other listeners run
+    // first, in order, on the calling thread. Returns once every listener
+    // ran and rethrows the first exception a listener threw. Listeners
+    // must not be destroyed while this runs.
+    template<EventWorkerPool TPool>
+    void invokeParallel(TPool& pool,
+                        size_t chunkSize,
+                        EventArg<TArgs>... args);
+
+    // Delivers a batch listener by listener rather than event by event,
+    // which keeps each listener's state in cache for the whole batch.
+    // Listeners removed by the batch still receive the rest of it.
+    void emitBatch(
+        std::span<const typename EventListener<TArgs...>::BatchEvent> events);
+
+#ifdef CU_EVENT_INSTRUMENTATION
+    // Listener stats only cover the listeners connected right now, and are
+    // not recorded for listeners run in parallel.
+    EventHandlerStats stats() const;
+    void              resetStats() noexcept;
+#endif
+
+private:
+    template<typename TCall>
+    void notifySlot(size_t index, TCall&& call);
+    void beginInvoke();
+    void endInvoke();
+    void disconnect(uint32_t slot);
+    void disconnectAll();
+    void adopt(EventHandler<TArgs...>& other);
 
 #pragma endregion
 
 #pragma region ____________________________ Fields _____________________________
 
 private:
-    bool                                _invoking{};
-    std::list<EventListener<TArgs...>*> _listeners{};
-    std::list<EventListener<TArgs...>*> _listenersToAdd{};
-    std::list<EventListener<TArgs...>*> _listenersToRemove{};
+    // Subscriptions made while invoking are appended past the slots being
+    // iterated, so they take effect from the next invocation. Removals are
+    // deferred to _listenersToRemove for the same reason.
+    unsigned                     _invokeDepth{};
+    size_t                       _listenerCount{};
+    std::vector<Slot>            _slots{};
+    std::vector<uint32_t>        _freeSlots{};
+    std::vector<EventConnection> _listenersToRemove{};
+
+#ifdef CU_EVENT_INSTRUMENTATION
+    uint64_t                              _emitCount{};
+    EventLatencyStats                     _emitLatency{};
+    size_t                                _peakPendingRemovals{};
+    std::chrono::steady_clock::time_point _emitStart{};
+#endif
 
 #pragma endregion
 };
@@ -108,70 +318,159 @@ private:
 #pragma region EventListenerImpl
 
 template<typename... TArgs>
-EventListener<TArgs...>::EventListener(std::function<void(TArgs...)> callback)
+EventListener<TArgs...>::EventListener(
+    Delegate<void(EventArg<TArgs>...)> callback)
     : _callback{std::move(callback)}
 {
 }
 
+template<typename... TArgs>
+template<CopyingEventCallback<TArgs...> TCallable>
+EventListener<TArgs...>::EventListener(TCallable callback)
+    : _callback{
+          [callback = std::move(callback)](EventArg<TArgs>... args) mutable
+          {
+              std::tuple<std::remove_cvref_t<TArgs>...> copies{args...};
+              std::apply(callback, copies);
+          }}
+{
+}
+
 template<typename... TArgs>
 EventListener<TArgs...>::~EventListener()
 {
-    for (auto handler : _handlers)
-        handler->_listeners.remove(this);
+    disconnectAll();
 }
 
 template<typename... TArgs>
 EventListener<TArgs...>::EventListener(EventListener<TArgs...>&& other)
+    : _callback{std::move(other._callback)}
+    , _consumer{std::move(other._consumer)}
+    , _batch{std::move(other._batch)}
+    , _connections{std::move(other._connections)}
+    , _independent{other._independent}
 {
-    _callback = std::move(other._callback);
-    _handlers = std::move(other._handlers);
+    other._connections.clear();
 
-    for (auto handler : _handlers)
-    {
-        handler->_listeners.remove(&other);
-        handler->_listeners.push_back(this);
-    }
+    for (auto& connection : _connections)
+        connection.handler->_slots[connection.slot].listener = this;
 }
 
 template<typename... TArgs>
 EventListener<TArgs...>&
 EventListener<TArgs...>::operator=(EventListener<TArgs...>&& other)
 {
-    _callback = std::move(other._callback);
-    _handlers = std::move(other._handlers);
+    if (this == &other)
+        return *this;
 
-    for (auto handler : _handlers)
-    {
-        handler->_listeners.remove(&other);
-        handler->_listeners.push_back(this);
-    }
+    disconnectAll();
+
+    _callback    = std::move(other._callback);
+    _consumer    = std::move(other._consumer);
+    _batch       = std::move(other._batch);
+    _connections = std::move(other._connections);
+    _independent = other._independent;
+    other._connections.clear();
+
+    for (auto& connection : _connections)
+        connection.handler->_slots[connection.slot].listener = this;
 
     return *this;
 }
 
 template<typename... TArgs>
 EventListener<TArgs...>::EventListener(const EventListener<TArgs...>& other)
+    : _callback{other._callback}
+    , _consumer{other._consumer}
+    , _batch{other._batch}
+    , _independent{other._independent}
 {
-    _callback = other._callback;
-    _handlers = other._handlers;
-
-    for (auto handler : _handlers)
-        handler->_listeners.push_back(this);
+    for (auto& connection : other._connections)
+        connection.handler->subscribe(*this);
 }
 
 template<typename... TArgs>
 EventListener<TArgs...>&
 EventListener<TArgs...>::operator=(const EventListener<TArgs...>& other)
 {
-    _callback = other._callback;
-    _handlers = other._handlers;
+    if (this == &other)
+        return *this;
+
+    disconnectAll();
 
-    for (auto handler : _handlers)
-        handler->_listeners.push_back(this);
+    _callback    = other._callback;
+    _consumer    = other._consumer;
+    _batch       = other._batch;
+    _independent = other._independent;
+
+    for (auto& connection : other._connections)
+        connection.handler->subscribe(*this);
 
     return *this;
 }
 
+template<typename... TArgs>
+EventListener<TArgs...>
+EventListener<TArgs...>::consuming(
+    Delegate<void(std::remove_cvref_t<TArgs>&&...)> callback)
+{
+    EventListener<TArgs...> listener;
+    listener._consumer = std::move(callback);
+
+    return listener;
+}
+
+template<typename... TArgs>
+EventListener<TArgs...>
+EventListener<TArgs...>::batched(
+    Delegate<void(std::span<const BatchEvent>)> callback)
+{
+    EventListener<TArgs...> listener;
+    listener._batch = std::move(callback);
+
+    return listener;
+}
+
+template<typename... TArgs>
+void
+EventListener<TArgs...>::setIndependent(bool independent) noexcept
+{
+    _independent = independent;
+}
+
+template<typename... TArgs>
+bool
+EventListener<TArgs...>::isIndependent() const noexcept
+{
+    return _independent;
+}
+
+template<typename... TArgs>
+void
+EventListener<TArgs...>::notify(EventArg<TArgs>... args) const
+{
+    if (_consumer)
+        _consumer(std::remove_cvref_t<TArgs>(args)...);
+    else if (_batch)
+    {
+        const BatchEvent event{args...};
+        _batch(std::span<const BatchEvent>{&event, 1});
+    }
+    else
+        _callback(args...);
+}
+
+template<typename... TArgs>
+void
+EventListener<TArgs...>::disconnectAll()
+{
+    while (!_connections.empty())
+    {
+        auto connection = _connections.back();
+        connection.handler->disconnect(connection.slot);
+    }
+}
+
 #pragma endregion
 
 #pragma region EventHandlerImpl
@@ -179,33 +478,24 @@ EventListener<TArgs...>::operator=(const EventListener<TArgs...>& other)
 template<typename... TArgs>
 EventHandler<TArgs...>::~EventHandler()
 {
-    for (auto listener : _listeners)
-        listener->_handlers.remove(this);
+    disconnectAll();
 }
 
 template<typename... TArgs>
 EventHandler<TArgs...>::EventHandler(EventHandler<TArgs...>&& other)
 {
-    _listeners = std::move(other._listeners);
-
-    for (auto listener : _listeners)
-    {
-        listener->_handlers.remove(&other);
-        listener->_handlers.push_back(this);
-    }
+    adopt(other);
 }
 
 template<typename... TArgs>
 EventHandler<TArgs...>&
 EventHandler<TArgs...>::operator=(EventHandler<TArgs...>&& other)
 {
-    _listeners = std::move(other._listeners);
+    if (this == &other)
+        return *this;
 
-    for (auto listener : _listeners)
-    {
-        listener->_handlers.remove(&other);
-        listener->_handlers.push_back(this);
-    }
+    disconnectAll();
+    adopt(other);
 
     return *this;
 }
@@ -213,20 +503,23 @@ EventHandler<TArgs...>::operator=(EventHandler<TArgs...>&& other)
 template<typename... TArgs>
 EventHandler<TArgs...>::EventHandler(const EventHandler<TArgs...>& other)
 {
-    _listeners = other._listeners;
-
-    for (auto listener : _listeners)
-        listener->_handlers.push_back(this);
+    for (auto& slot : other._slots)
+        if (nullptr != slot.listener)
+            subscribe(*slot.listener);
 }
 
 template<typename... TArgs>
 EventHandler<TArgs...>&
 EventHandler<TArgs...>::operator=(const EventHandler<TArgs...>& other)
 {
-    _listeners = other._listeners;
+    if (this == &other)
+        return *this;
+
+    disconnectAll();
 
-    for (auto listener : _listeners)
-        listener->_handlers.push_back(this);
+    for (auto& slot : other._slots)
+        if (nullptr != slot.listener)
+            subscribe(*slot.listener);
 
     return *this;
 }
@@ -235,54 +528,364 @@ template<typename... TArgs>
 void
 EventHandler<TArgs...>::operator+=(EventListener<TArgs...>& listener)
 {
-    if (_invoking)
-        _listenersToAdd.push_back(&listener);
+    subscribe(listener);
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::operator-=(EventListener<TArgs...>& listener)
+{
+    auto& connections = listener._connections;
+
+    // Walking backwards keeps the swap-removal in disconnect() from moving
+    // an unvisited connection behind the cursor.
+    for (size_t i = connections.size(); i-- > 0;)
+    {
+        if (this != connections[i].handler)
+            continue;
+
+        if (_invokeDepth > 0)
+        {
+            auto slot = connections[i].slot;
+            _listenersToRemove.push_back({slot, _slots[slot].generation});
+        }
+        else
+            disconnect(connections[i].slot);
+    }
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::operator()(EventArg<TArgs>... args)
+{
+    beginInvoke();
+
+    for (size_t i = 0, count = _slots.size(); i < count; ++i)
+        if (auto listener = _slots[i].listener)
+            notifySlot(i, [&] { listener->notify(args...); });
+
+    endInvoke();
+}
+
+template<typename... TArgs>
+EventConnection
+EventHandler<TArgs...>::subscribe(EventListener<TArgs...>& listener)
+{
+    uint32_t index;
+
+    // Free slots are not reused while invoking, a reused slot could be
+    // visited by the ongoing iteration.
+    if (0 == _invokeDepth && !_freeSlots.empty())
+    {
+        index = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
     else
     {
-        _listeners.push_back(&listener);
-        listener._handlers.push_back(this);
+        index = static_cast<uint32_t>(_slots.size());
+        _slots.push_back({nullptr, 0, 1});
     }
+
+    auto& slot      = _slots[index];
+    slot.listener   = &listener;
+    slot.connection = static_cast<uint32_t>(listener._connections.size());
+    listener._connections.push_back({this, index});
+    ++_listenerCount;
+
+#ifdef CU_EVENT_INSTRUMENTATION
+    slot.stats = {};
+#endif
+
+    return {index, slot.generation};
 }
 
 template<typename... TArgs>
 void
-EventHandler<TArgs...>::operator-=(EventListener<TArgs...>& listener)
+EventHandler<TArgs...>::unsubscribe(EventConnection connection)
 {
-    if (_invoking)
-        _listenersToRemove.push_back(&listener);
+    if (!isConnected(connection))
+        return;
+
+    if (_invokeDepth > 0)
+        _listenersToRemove.push_back(connection);
     else
+        disconnect(connection.index);
+}
+
+template<typename... TArgs>
+bool
+EventHandler<TArgs...>::isConnected(EventConnection connection) const noexcept
+{
+    return connection.index < _slots.size() &&
+           _slots[connection.index].generation == connection.generation &&
+           nullptr != _slots[connection.index].listener;
+}
+
+template<typename... TArgs>
+size_t
+EventHandler<TArgs...>::listenerCount() const noexcept
+{
+    return _listenerCount;
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::emitMoving(std::remove_cvref_t<TArgs>&&... args)
+{
+    beginInvoke();
+
+    auto count = _slots.size();
+    auto last  = count;
+
+    while (last > 0 && nullptr == _slots[last - 1].listener)
+        --last;
+
+    // Only the last listener may take the arguments, everyone before it
+    // still has to see them intact.
+    if (last > 0 && _slots[last - 1].listener->_consumer)
+        --last;
+    else
+        last = count;
+
+    for (size_t i = 0; i < last; ++i)
+        if (auto listener = _slots[i].listener)
+            notifySlot(i, [&] { listener->notify(args...); });
+
+    if (last != count)
+        if (auto listener = _slots[last].listener)
+            notifySlot(last,
+                       [&] { listener->_consumer(std::move(args)...); });
+
+    endInvoke();
+}
+
+template<typename... TArgs>
+template<EventWorkerPool TPool>
+void
+EventHandler<TArgs...>::invokeParallel(TPool& pool,
+                                       size_t chunkSize,
+                                       EventArg<TArgs>... args)
+{
+    beginInvoke();
+
+    std::vector<EventListener<TArgs...>*> independent;
+
+    try
+    {
+        for (size_t i = 0, count = _slots.size(); i < count; ++i)
+        {
+            auto listener = _slots[i].listener;
+
+            if (nullptr == listener)
+                continue;
+
+            if (listener->_independent)
+                independent.push_back(listener);
+            else
+                notifySlot(i, [&] { listener->notify(args...); });
+        }
+
+        pool.parallelFor(independent.size(),
+                         chunkSize,
+                         [&independent, &args...](size_t first, size_t last)
+                         {
+                             for (auto i = first; i < last; ++i)
+                                 independent[i]->notify(args...);
+                         });
+    }
+    catch (...)
     {
-        _listeners.remove(&listener);
-        listener._handlers.remove(this);
+        endInvoke();
+        throw;
     }
+
+    endInvoke();
 }
 
 template<typename... TArgs>
 void
-EventHandler<TArgs...>::operator()(TArgs... args)
+EventHandler<TArgs...>::emitBatch(
+    std::span<const typename EventListener<TArgs...>::BatchEvent> events)
 {
-    _invoking = true;
+    if (events.empty())
+        return;
 
-    for (auto listener : _listeners)
-        listener->_callback(args...);
+    beginInvoke();
 
-    for (auto listener : _listenersToAdd)
+    for (size_t i = 0, count = _slots.size(); i < count; ++i)
     {
-        _listeners.push_back(listener);
-        listener->_handlers.push_back(this);
+        auto listener = _slots[i].listener;
+
+        if (nullptr == listener)
+            continue;
+
+        if (listener->_batch)
+        {
+            notifySlot(i, [&] { listener->_batch(events); });
+
+            continue;
+        }
+
+        notifySlot(i,
+                   [&]
+                   {
+                       // A listener can destroy itself midway, the slot
+                       // is cleared when it does.
+                       for (auto& event : events)
+                       {
+                           if (nullptr == _slots[i].listener)
+                               break;
+
+                           std::apply([listener](auto&... args)
+                                      { listener->notify(args...); },
+                                      event);
+                       }
+                   });
     }
 
-    _listenersToAdd.clear();
+    endInvoke();
+}
+
+#ifdef CU_EVENT_INSTRUMENTATION
+
+template<typename... TArgs>
+EventHandlerStats
+EventHandler<TArgs...>::stats() const
+{
+    EventHandlerStats stats;
+    stats.emitCount           = _emitCount;
+    stats.emitLatency         = _emitLatency;
+    stats.pendingRemovals     = _listenersToRemove.size();
+    stats.peakPendingRemovals = _peakPendingRemovals;
+    stats.listeners.reserve(_listenerCount);
+
+    for (uint32_t i = 0; i < _slots.size(); ++i)
+        if (nullptr != _slots[i].listener)
+            stats.listeners.push_back(
+                {{i, _slots[i].generation}, _slots[i].stats});
+
+    return stats;
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::resetStats() noexcept
+{
+    _emitCount           = 0;
+    _emitLatency         = {};
+    _peakPendingRemovals = 0;
+
+    for (auto& slot : _slots)
+        slot.stats = {};
+}
+
+#endif
+
+template<typename... TArgs>
+template<typename TCall>
+void
+EventHandler<TArgs...>::notifySlot([[maybe_unused]] size_t index, TCall&& call)
+{
+#ifdef CU_EVENT_INSTRUMENTATION
+    auto start = std::chrono::steady_clock::now();
+    call();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // The call may have grown _slots, so the slot is looked up afterwards.
+    _slots[index].stats.record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+            .count());
+#else
+    call();
+#endif
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::beginInvoke()
+{
+#ifdef CU_EVENT_INSTRUMENTATION
+    ++_emitCount;
+
+    if (0 == _invokeDepth)
+        _emitStart = std::chrono::steady_clock::now();
+#endif
+
+    ++_invokeDepth;
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::endInvoke()
+{
+    if (0 != --_invokeDepth)
+        return;
+
+#ifdef CU_EVENT_INSTRUMENTATION
+    _emitLatency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - _emitStart)
+                            .count());
+    _peakPendingRemovals =
+        std::max(_peakPendingRemovals, _listenersToRemove.size());
+#endif
+
+    for (auto connection : _listenersToRemove)
+        if (isConnected(connection))
+            disconnect(connection.index);
+
+    _listenersToRemove.clear();
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::disconnect(uint32_t index)
+{
+    auto& slot        = _slots[index];
+    auto& connections = slot.listener->_connections;
 
-    for (auto listener : _listenersToRemove)
+    if (slot.connection + 1 != connections.size())
     {
-        _listeners.remove(listener);
-        listener->_handlers.remove(this);
+        auto& moved = connections.back();
+        moved.handler->_slots[moved.slot].connection = slot.connection;
+        connections[slot.connection]                 = moved;
     }
 
+    connections.pop_back();
+
+    slot.listener = nullptr;
+    ++slot.generation;
+    _freeSlots.push_back(index);
+    --_listenerCount;
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::disconnectAll()
+{
+    for (uint32_t i = 0; i < _slots.size(); ++i)
+        if (nullptr != _slots[i].listener)
+            disconnect(i);
+
+    _slots.clear();
+    _freeSlots.clear();
     _listenersToRemove.clear();
+}
+
+template<typename... TArgs>
+void
+EventHandler<TArgs...>::adopt(EventHandler<TArgs...>& other)
+{
+    _slots         = std::move(other._slots);
+    _freeSlots     = std::move(other._freeSlots);
+    _listenerCount = other._listenerCount;
+
+    other._slots.clear();
+    other._freeSlots.clear();
+    other._listenerCount = 0;
 
-    _invoking = false;
+    for (auto& slot : _slots)
+        if (nullptr != slot.listener)
+            slot.listener->_connections[slot.connection].handler = this;
 }
 
 #pragma endregion
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "event.hpp"
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace cu
+{
+
+// Routes published events to the listeners of their type. Every event type
+// gets a dense index the first time it is used, so publishing is an array
+// access followed by a regular EventHandler invocation.
+class EventBus
+{
+#pragma region ____________________________ Types ______________________________
+
+private:
+    struct ChannelBase
+    {
+        virtual ~ChannelBase() = default;
+    };
+
+    template<typename TEvent>
+    struct Channel : ChannelBase
+    {
+        EventHandler<const TEvent&> handler{};
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    EventBus() = default;
+    ~EventBus() = default;
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    // Channels live on the heap, so moving the bus keeps listeners attached.
+    EventBus(EventBus&& other) = default;
+    EventBus& operator=(EventBus&& other) = default;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    EventBus(const EventBus& other) = delete;
+    EventBus& operator=(const EventBus& other) = delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    template<typename TEvent>
+    EventConnection subscribe(EventListener<const TEvent&>& listener)
+    {
+        return channel<TEvent>().handler.subscribe(listener);
+    }
+
+    template<typename TEvent>
+    void unsubscribe(EventListener<const TEvent&>& listener)
+    {
+        if (auto found = find<TEvent>())
+            found->handler -= listener;
+    }
+
+    template<typename TEvent>
+    void unsubscribe(EventConnection connection)
+    {
+        if (auto found = find<TEvent>())
+            found->handler.unsubscribe(connection);
+    }
+
+    template<typename TEvent>
+    void publish(const TEvent& event)
+    {
+        if (auto found = find<TEvent>())
+            found->handler(event);
+    }
+
+    template<typename TEvent>
+    size_t listenerCount() const noexcept
+    {
+        auto found = find<TEvent>();
+
+        return nullptr == found ? 0 : found->handler.listenerCount();
+    }
+
+private:
+    static size_t nextTypeIndex() noexcept
+    {
+        static std::atomic<size_t> next{};
+
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<typename TEvent>
+    static size_t typeIndex() noexcept
+    {
+        static const size_t index = nextTypeIndex();
+
+        return index;
+    }
+
+    template<typename TEvent>
+    Channel<TEvent>* find() const noexcept
+    {
+        static_assert(std::is_same_v<TEvent, std::remove_cvref_t<TEvent>>,
+                      "Event types must not be references or cv-qualified.");
+
+        auto index = typeIndex<TEvent>();
+
+        if (index >= _channels.size())
+            return nullptr;
+
+        return static_cast<Channel<TEvent>*>(_channels[index].get());
+    }
+
+    template<typename TEvent>
+    Channel<TEvent>& channel()
+    {
+        auto index = typeIndex<TEvent>();
+
+        if (index >= _channels.size())
+            _channels.resize(index + 1);
+
+        auto& slot = _channels[index];
+
+        if (!slot)
+            slot = std::make_unique<Channel<TEvent>>();
+
+        return static_cast<Channel<TEvent>&>(*slot);
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    std::vector<std::unique_ptr<ChannelBase>> _channels{};
+
+#pragma endregion
+};
+
+}
@@ -0,0 +1,480 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "event.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cu
+{
+
+// Customization point describing how an event argument is stored in an
+// event log. Specializations provide size(), write() and read(); write and
+// read advance the cursor past the bytes they handled.
+template<typename T>
+struct EventSerializer;
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+struct EventSerializer<T>
+{
+    static size_t size(const T&) noexcept
+    {
+        return sizeof(T);
+    }
+
+    static void write(std::byte*& cursor, const T& value) noexcept
+    {
+        std::memcpy(cursor, &value, sizeof(T));
+        cursor += sizeof(T);
+    }
+
+    static T read(const std::byte*& cursor) noexcept
+    {
+        T value;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+
+        return value;
+    }
+};
+
+template<>
+struct EventSerializer<std::string>
+{
+    static size_t size(const std::string& value) noexcept
+    {
+        return sizeof(uint64_t) + value.size();
+    }
+
+    static void write(std::byte*& cursor, const std::string& value) noexcept
+    {
+        EventSerializer<uint64_t>::write(cursor, value.size());
+        std::memcpy(cursor, value.data(), value.size());
+        cursor += value.size();
+    }
+
+    static std::string read(const std::byte*& cursor)
+    {
+        auto size = EventSerializer<uint64_t>::read(cursor);
+        std::string value(reinterpret_cast<const char*>(cursor), size);
+        cursor += size;
+
+        return value;
+    }
+};
+
+template<typename T>
+concept SerializableEvent = requires(const T&          value,
+                                     std::byte*&       out,
+                                     const std::byte*& in) {
+    { EventSerializer<T>::size(value) } -> std::convertible_to<size_t>;
+    EventSerializer<T>::write(out, value);
+    { EventSerializer<T>::read(in) } -> std::same_as<T>;
+};
+
+// Layout shared by EventRecorder and EventPlayer. The log is a header
+// followed by records of a RecordHeader and the serialized arguments,
+// each padded to 8 bytes. Only the first committedBytes after the header
+// are valid, which keeps a log readable if the recorder dies midway.
+struct EventLog
+{
+    static constexpr uint64_t magic = 0x6375'6576'6c6f'6731; // "cuevlog1"
+
+    struct Header
+    {
+        uint64_t              magic;
+        uint64_t              argumentCount;
+        std::atomic<uint64_t> committedBytes;
+    };
+
+    struct RecordHeader
+    {
+        uint64_t timestampNanoseconds;
+        uint64_t size;
+    };
+
+    static constexpr size_t align(size_t size) noexcept
+    {
+        return (size + 7) & ~size_t{7};
+    }
+
+    [[noreturn]] static void throwSystemError(const char* what,
+                                              int         error = errno)
+    {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+};
+
+// Appends every emission of a handler with its time since the recorder
+// was created to a memory-mapped log file.
+template<typename... TArgs>
+    requires(SerializableEvent<std::remove_cvref_t<TArgs>> && ...)
+class EventRecorder
+{
+#pragma region _________________________ Constructors __________________________
+
+public:
+    EventRecorder(EventHandler<TArgs...>& handler, const std::string& path)
+        : _listener{[this](EventArg<TArgs>... args) { record(args...); }}
+    {
+        _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if (-1 == _fd)
+            EventLog::throwSystemError("open");
+
+        try
+        {
+            resize(initialSize);
+        }
+        catch (...)
+        {
+            ::close(_fd);
+            throw;
+        }
+
+        auto header           = ::new (_mapping) EventLog::Header{};
+        header->magic         = EventLog::magic;
+        header->argumentCount = sizeof...(TArgs);
+
+        _start = std::chrono::steady_clock::now();
+        handler += _listener;
+    }
+
+    // Trims the file to the recorded events.
+    ~EventRecorder()
+    {
+        auto committed = header().committedBytes.load();
+
+        ::munmap(_mapping, _mappingSize);
+        [[maybe_unused]] auto result = ::ftruncate(
+            _fd, static_cast<off_t>(sizeof(EventLog::Header) + committed));
+        ::close(_fd);
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    EventRecorder(EventRecorder<TArgs...>&& other) = delete;
+    EventRecorder<TArgs...>& operator=(EventRecorder<TArgs...>&& other) =
+        delete;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    EventRecorder(const EventRecorder<TArgs...>& other) = delete;
+    EventRecorder<TArgs...>& operator=(const EventRecorder<TArgs...>& other) =
+        delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    size_t recordedCount() const noexcept
+    {
+        return _recordedCount;
+    }
+
+private:
+    static constexpr size_t initialSize = 64 * 1024;
+
+    EventLog::Header& header() const noexcept
+    {
+        return *static_cast<EventLog::Header*>(_mapping);
+    }
+
+    void record(EventArg<TArgs>... args)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - _start;
+        auto payload =
+            (size_t{} + ... +
+             EventSerializer<std::remove_cvref_t<TArgs>>::size(args));
+        auto recordSize =
+            EventLog::align(sizeof(EventLog::RecordHeader) + payload);
+        auto committed = header().committedBytes.load();
+        auto end       = sizeof(EventLog::Header) + committed + recordSize;
+
+        if (end > _mappingSize)
+            resize(std::max(end, _mappingSize * 2));
+
+        auto cursor = static_cast<std::byte*>(_mapping) +
+                      sizeof(EventLog::Header) + committed;
+
+        EventLog::RecordHeader record{
+            static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count()),
+            payload};
+        EventSerializer<EventLog::RecordHeader>::write(cursor, record);
+        (EventSerializer<std::remove_cvref_t<TArgs>>::write(cursor, args),
+         ...);
+
+        header().committedBytes.store(committed + recordSize,
+                                      std::memory_order_release);
+        ++_recordedCount;
+    }
+
+    void resize(size_t size)
+    {
+        if (-1 == ::ftruncate(_fd, static_cast<off_t>(size)))
+            EventLog::throwSystemError("ftruncate");
+
+        auto mapping =
+            ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+
+        if (MAP_FAILED == mapping)
+            EventLog::throwSystemError("mmap");
+
+        if (nullptr != _mapping)
+            ::munmap(_mapping, _mappingSize);
+
+        _mapping     = mapping;
+        _mappingSize = size;
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    int                                   _fd{-1};
+    void*                                 _mapping{};
+    size_t                                _mappingSize{};
+    size_t                                _recordedCount{};
+    std::chrono::steady_clock::time_point _start{};
+    EventListener<TArgs...>               _listener;
+
+#pragma endregion
+};
+
+enum class ReplaySpeed
+{
+    original,
+    maximum
+};
+
+// Re-emits a log written by EventRecorder with the same argument types.
+template<typename... TArgs>
+    requires(SerializableEvent<std::remove_cvref_t<TArgs>> && ...)
+class EventPlayer
+{
+#pragma region _________________________ Constructors __________________________
+
+public:
+    explicit EventPlayer(const std::string& path)
+    {
+        auto fd = ::open(path.c_str(), O_RDONLY);
+
+        if (-1 == fd)
+            EventLog::throwSystemError("open");
+
+        struct stat info;
+
+        if (-1 == ::fstat(fd, &info))
+        {
+            auto error = errno;
+            ::close(fd);
+            EventLog::throwSystemError("fstat", error);
+        }
+
+        _mappingSize = static_cast<size_t>(info.st_size);
+
+        if (_mappingSize < sizeof(EventLog::Header))
+        {
+            ::close(fd);
+            throw std::runtime_error("File is not an event log.");
+        }
+
+        _mapping = ::mmap(nullptr, _mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+        auto error = errno;
+        ::close(fd);
+
+        if (MAP_FAILED == _mapping)
+            EventLog::throwSystemError("mmap", error);
+
+        auto header = static_cast<const EventLog::Header*>(_mapping);
+
+        if (EventLog::magic != header->magic ||
+            sizeof...(TArgs) != header->argumentCount)
+        {
+            ::munmap(_mapping, _mappingSize);
+            throw std::runtime_error("File is not an event log of this "
+                                     "event type.");
+        }
+
+        _begin  = static_cast<const std::byte*>(_mapping) +
+                 sizeof(EventLog::Header);
+        _end    = _begin + std::min<size_t>(header->committedBytes.load(),
+                                            _mappingSize -
+                                                sizeof(EventLog::Header));
+        _cursor = _begin;
+    }
+
+    ~EventPlayer()
+    {
+        ::munmap(_mapping, _mappingSize);
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    EventPlayer(EventPlayer<TArgs...>&& other) = delete;
+    EventPlayer<TArgs...>& operator=(EventPlayer<TArgs...>&& other) = delete;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    EventPlayer(const EventPlayer<TArgs...>& other) = delete;
+    EventPlayer<TArgs...>& operator=(const EventPlayer<TArgs...>& other) =
+        delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    bool finished() const noexcept
+    {
+        return _cursor >= _end;
+    }
+
+    void rewind() noexcept
+    {
+        _cursor = _begin;
+    }
+
+    // Emits the next recorded event, returns false at the end of the log.
+    bool emitNext(EventHandler<TArgs...>& handler)
+    {
+        EventLog::RecordHeader record;
+
+        if (!readRecordHeader(record))
+            return false;
+
+        emit(handler, record);
+
+        return true;
+    }
+
+    // Emits the rest of the log. At original speed the gaps between events
+    // are kept, measured from the first event emitted by this call.
+    size_t play(EventHandler<TArgs...>& handler,
+                ReplaySpeed             speed = ReplaySpeed::original)
+    {
+        size_t emitted = 0;
+        auto   start   = std::chrono::steady_clock::now();
+        auto   first   = uint64_t{};
+
+        EventLog::RecordHeader record;
+
+        while (readRecordHeader(record))
+        {
+            if (0 == emitted)
+                first = record.timestampNanoseconds;
+
+            if (ReplaySpeed::original == speed)
+                std::this_thread::sleep_until(
+                    start + std::chrono::nanoseconds{
+                                record.timestampNanoseconds - first});
+
+            emit(handler, record);
+            ++emitted;
+        }
+
+        return emitted;
+    }
+
+private:
+    // Reads the header of the next record if the whole record is in the
+    // log. A record cut short, e.g. by a full disk, ends the log instead.
+    bool readRecordHeader(EventLog::RecordHeader& record) noexcept
+    {
+        auto remaining = static_cast<size_t>(_end - _cursor);
+
+        if (remaining < sizeof(EventLog::RecordHeader))
+        {
+            _cursor = _end;
+
+            return false;
+        }
+
+        auto cursor = _cursor;
+        record      = EventSerializer<EventLog::RecordHeader>::read(cursor);
+        remaining -= sizeof(EventLog::RecordHeader);
+
+        if (record.size > remaining ||
+            EventLog::align(sizeof(EventLog::RecordHeader) + record.size) -
+                    sizeof(EventLog::RecordHeader) >
+                remaining)
+        {
+            _cursor = _end;
+
+            return false;
+        }
+
+        _cursor = cursor;
+
+        return true;
+    }
+
+    void emit(EventHandler<TArgs...>& handler, EventLog::RecordHeader record)
+    {
+        auto next = _cursor +
+                    EventLog::align(sizeof(EventLog::RecordHeader) +
+                                    record.size) -
+                    sizeof(EventLog::RecordHeader);
+
+        // Braced initialization reads the arguments in order.
+        std::tuple<std::remove_cvref_t<TArgs>...> values{
+            EventSerializer<std::remove_cvref_t<TArgs>>::read(_cursor)...};
+        _cursor = next;
+
+        std::apply([&handler](auto&... args)
+                   { handler.emitMoving(std::move(args)...); },
+                   values);
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    void*            _mapping{};
+    size_t           _mappingSize{};
+    const std::byte* _begin{};
+    const std::byte* _end{};
+    const std::byte* _cursor{};
+
+#pragma endregion
+};
+
+}
+
+#endif
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "event.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+namespace cu
+{
+
+// An event whose invocation is decoupled from its emission. post() copies
+// the arguments into a preallocated ring and returns; the listeners run
+// later on whichever thread calls drain(), or on the dispatcher thread.
+//
+// Any number of threads may post. Draining, and changing the listeners,
+// must happen on one thread at a time, normally the dispatcher.
+template<typename... TArgs>
+class QueuedEventHandler
+{
+    static_assert(
+        !(... || (std::is_lvalue_reference_v<TArgs> &&
+                  !std::is_const_v<std::remove_reference_t<TArgs>>)),
+        "Queued arguments are copied, mutable references cannot be queued.");
+
+#pragma region ____________________________ Types ______________________________
+
+private:
+    using Payload = std::tuple<std::remove_cvref_t<TArgs>...>;
+
+    // A cell is writable by the producer that claimed position p while
+    // sequence == p, and readable by the consumer once sequence == p + 1.
+    struct Cell
+    {
+        std::atomic<size_t>    sequence{};
+        std::optional<Payload> payload{};
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    // capacity is rounded up to a power of two.
+    explicit QueuedEventHandler(size_t capacity = 1024)
+        : _capacity{std::bit_ceil(std::max<size_t>(capacity, 2))}
+        , _cells{std::make_unique<Cell[]>(_capacity)}
+    {
+        for (size_t i = 0; i < _capacity; ++i)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~QueuedEventHandler()
+    {
+        stop();
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    QueuedEventHandler(QueuedEventHandler<TArgs...>&& other) = delete;
+    QueuedEventHandler<TArgs...>& operator=(
+        QueuedEventHandler<TArgs...>&& other) = delete;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    QueuedEventHandler(const QueuedEventHandler<TArgs...>& other) = delete;
+    QueuedEventHandler<TArgs...>& operator=(
+        const QueuedEventHandler<TArgs...>& other) = delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    void operator+=(EventListener<TArgs...>& listener)
+    {
+        _handler += listener;
+    }
+
+    void operator-=(EventListener<TArgs...>& listener)
+    {
+        _handler -= listener;
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    EventConnection subscribe(EventListener<TArgs...>& listener)
+    {
+        return _handler.subscribe(listener);
+    }
+
+    void unsubscribe(EventConnection connection)
+    {
+        _handler.unsubscribe(connection);
+    }
+
+    size_t listenerCount() const noexcept
+    {
+        return _handler.listenerCount();
+    }
+
+    size_t capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    // Returns false without blocking when the queue is full.
+    template<typename... TValues>
+        requires std::is_constructible_v<Payload, TValues&&...>
+    bool post(TValues&&... values)
+    {
+        auto  position = _tail.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &_cells[position & (_capacity - 1)];
+
+            auto sequence = cell->sequence.load(std::memory_order_acquire);
+            auto distance = static_cast<std::ptrdiff_t>(sequence - position);
+
+            if (0 == distance)
+            {
+                if (_tail.compare_exchange_weak(position,
+                                                position + 1,
+                                                std::memory_order_relaxed))
+                    break;
+            }
+            else if (distance < 0)
+                return false;
+            else
+                position = _tail.load(std::memory_order_relaxed);
+        }
+
+        cell->payload.emplace(std::forward<TValues>(values)...);
+        cell->sequence.store(position + 1, std::memory_order_seq_cst);
+
+        if (_dispatcherSleeping.load(std::memory_order_seq_cst))
+        {
+            _wakeups.fetch_add(1, std::memory_order_release);
+            _wakeups.notify_one();
+        }
+
+        return true;
+    }
+
+    // Invokes the listeners for up to maxBatch queued events and returns how
+    // many were delivered.
+    size_t drain(size_t maxBatch = static_cast<size_t>(-1))
+    {
+        size_t delivered = 0;
+
+        while (delivered < maxBatch)
+        {
+            // Only the consumer writes the head, so its own reads need no
+            // ordering.
+            auto  head     = _head.load(std::memory_order_relaxed);
+            auto& cell     = _cells[head & (_capacity - 1)];
+            auto  sequence = cell.sequence.load(std::memory_order_acquire);
+
+            if (sequence != head + 1)
+                break;
+
+            // The cell is handed back before the listeners run, so a throwing
+            // listener cannot leave it claimed.
+            auto payload = std::move(*cell.payload);
+            cell.payload.reset();
+            cell.sequence.store(head + _capacity, std::memory_order_release);
+            _head.store(head + 1, std::memory_order_release);
+            ++delivered;
+
+            // The payload is ours, so a consuming last listener can take it.
+            std::apply([this](auto&... values)
+                       { _handler.emitMoving(std::move(values)...); },
+                       payload);
+        }
+
+        return delivered;
+    }
+
+    // May be called from any thread. Unless it is called by the thread
+    // that drains, the answer can be outdated by the time it returns.
+    bool empty() const noexcept
+    {
+        auto  head = _head.load(std::memory_order_acquire);
+        auto& cell = _cells[head & (_capacity - 1)];
+
+        return cell.sequence.load(std::memory_order_seq_cst) != head + 1;
+    }
+
+    // Starts a thread that drains the queue in batches of at most maxBatch,
+    // sleeping while it is empty.
+    void start(size_t maxBatch = 64)
+    {
+        if (_dispatcher.joinable())
+            throw std::runtime_error("Dispatcher is already running.");
+
+        _dispatcher = std::jthread{[this, maxBatch](std::stop_token token)
+                                   { dispatch(token, maxBatch); }};
+    }
+
+    // Stops the dispatcher thread. Events still queued are delivered on
+    // the calling thread before this returns.
+    void stop()
+    {
+        if (!_dispatcher.joinable())
+            return;
+
+        _dispatcher.request_stop();
+        _wakeups.fetch_add(1, std::memory_order_release);
+        _wakeups.notify_one();
+        _dispatcher.join();
+
+        drain();
+    }
+
+private:
+    void dispatch(std::stop_token token, size_t maxBatch)
+    {
+        while (!token.stop_requested())
+        {
+            if (0 != drain(maxBatch))
+                continue;
+
+            // Producers only notify while this flag is set. Setting it
+            // before checking the queue again means a post either lands
+            // before the check or sees the flag.
+            auto wakeups = _wakeups.load(std::memory_order_acquire);
+            _dispatcherSleeping.store(true, std::memory_order_seq_cst);
+
+            if (empty() && !token.stop_requested())
+                _wakeups.wait(wakeups, std::memory_order_acquire);
+
+            _dispatcherSleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    const size_t            _capacity;
+    std::unique_ptr<Cell[]> _cells;
+    EventHandler<TArgs...>  _handler{};
+
+    alignas(64) std::atomic<size_t> _tail{};
+    alignas(64) std::atomic<size_t> _head{};
+
+    std::atomic<bool>     _dispatcherSleeping{};
+    std::atomic<uint32_t> _wakeups{};
+    std::jthread          _dispatcher{};
+
+#pragma endregion
+};
+
+}
@@ -1,17 +1,51 @@
 #pragma once
 
+#include "delegate.hpp"
+#include "nullable.hpp"
+#include "smallvector.hpp"
+#include "stringarena.hpp"
 #include <string>
+#include <stdexcept>
+#include <string_view>
 #include <type_traits>
-#include "nullable.hpp"
 #include <list>
-#include <functional>
-#include <map>
+#include <unordered_map>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 
 namespace cu
 {
 
 class Result
 {
+#pragma region ____________________________ Types ______________________________
+
+public:
+    // The context is not copied, it has to outlive the result; string
+    // literals are the intended use. Frames without a value hold noValue.
+    struct ContextFrame
+    {
+        static constexpr long long noValue =
+            std::numeric_limits<long long>::min();
+
+        std::string_view context;
+        long long        value;
+
+        bool hasValue() const noexcept
+        {
+            return noValue != value;
+        }
+    };
+
+    // Every result carries this, successes included, so only the most
+    // common depths are kept inline.
+    using ContextFrames = SmallVector<ContextFrame, 2>;
+
+#pragma endregion
+
 #pragma region _________________________ Constructors __________________________
 
 public:
@@ -41,13 +75,73 @@ public:
         return _message;
     }
 
+    // Records where the result passed through without touching the
+    // message. Frames are kept innermost first.
+    Result& addContext(std::string_view context) &
+    {
+        _context.push_back({context, ContextFrame::noValue});
+
+        return *this;
+    }
+
+    Result& addContext(std::string_view context, long long value) &
+    {
+        _context.push_back({context, value});
+
+        return *this;
+    }
+
+    Result&& addContext(std::string_view context) &&
+    {
+        return std::move(addContext(context));
+    }
+
+    Result&& addContext(std::string_view context, long long value) &&
+    {
+        return std::move(addContext(context, value));
+    }
+
+    const ContextFrames& context() const noexcept
+    {
+        return _context;
+    }
+
+    // The message prefixed by every context frame, outermost first, e.g.
+    // "loading config: line 12: unexpected token".
+    std::string fullMessage() const
+    {
+        if (_context.empty())
+            return _message;
+
+        std::string result;
+
+        for (size_t i = _context.size(); i-- > 0;)
+        {
+            auto& frame = _context[i];
+            result += frame.context;
+
+            if (frame.hasValue())
+            {
+                result += ' ';
+                result += std::to_string(frame.value);
+            }
+
+            result += ": ";
+        }
+
+        result += _message;
+
+        return result;
+    }
+
 #pragma endregion
 
 #pragma region ____________________________ Fields _____________________________
 
 private:
-    bool        _succeeded;
-    std::string _message;
+    bool          _succeeded;
+    std::string   _message;
+    ContextFrames _context{};
 
 #pragma endregion
 };
@@ -71,9 +165,52 @@ public:
 
 #pragma endregion
 
+#pragma region ____________________________ Static _____________________________
+
+public:
+    // Carries a failure, including its context frames, over from a result
+    // of another type.
+    static DataResult<TData> propagate(Result failure)
+    {
+        if (failure.succeeded())
+            throw std::runtime_error("Can not propagate a succeeded result.");
+
+        DataResult<TData> result;
+        static_cast<Result&>(result) = std::move(failure);
+
+        return result;
+    }
+
+#pragma endregion
+
 #pragma region ___________________________ Methods _____________________________
 
 public:
+    DataResult<TData>& addContext(std::string_view context) &
+    {
+        Result::addContext(context);
+
+        return *this;
+    }
+
+    DataResult<TData>& addContext(std::string_view context, long long value) &
+    {
+        Result::addContext(context, value);
+
+        return *this;
+    }
+
+    DataResult<TData>&& addContext(std::string_view context) &&
+    {
+        return std::move(addContext(context));
+    }
+
+    DataResult<TData>&& addContext(std::string_view context,
+                                   long long        value) &&
+    {
+        return std::move(addContext(context, value));
+    }
+
     std::remove_reference_t<TData>& data()
     {
         if (failed())
@@ -221,6 +358,82 @@ private:
 
 class ResultCollector
 {
+#pragma region ____________________________ Types ______________________________
+
+public:
+    struct MessageCount
+    {
+        std::string_view message;
+        size_t           count;
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    ResultCollector() = default;
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    ResultCollector(ResultCollector&& other)            = default;
+    ResultCollector& operator=(ResultCollector&& other) = default;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    ResultCollector(const ResultCollector& other)
+        : _anySucceeded{other._anySucceeded}
+        , _anyFailed{other._anyFailed}
+        , _messages{other._messages}
+        , _deduplicating{other._deduplicating}
+        , _maxDistinctMessages{other._maxDistinctMessages}
+        , _droppedMessageCount{other._droppedMessageCount}
+    {
+        copyMessageCounts(other);
+    }
+
+    ResultCollector& operator=(const ResultCollector& other)
+    {
+        if (this == &other)
+            return *this;
+
+        _anySucceeded        = other._anySucceeded;
+        _anyFailed           = other._anyFailed;
+        _messages            = other._messages;
+        _deduplicating       = other._deduplicating;
+        _maxDistinctMessages = other._maxDistinctMessages;
+        _droppedMessageCount = other._droppedMessageCount;
+        copyMessageCounts(other);
+
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Static _____________________________
+
+public:
+    // Identical messages are stored once, in an arena, together with the
+    // number of times they were seen. Distinct messages beyond
+    // maxDistinctMessages are only counted by droppedMessageCount().
+    static ResultCollector deduplicating(
+        size_t maxDistinctMessages = std::numeric_limits<size_t>::max())
+    {
+        ResultCollector collector;
+        collector._deduplicating       = true;
+        collector._maxDistinctMessages = maxDistinctMessages;
+
+        return collector;
+    }
+
+#pragma endregion
+
 #pragma region ___________________________ Methods _____________________________
 
 public:
@@ -231,8 +444,11 @@ public:
         else
             _anySucceeded = true;
 
-        if (!result.message().empty())
-            _messages.push_back(result.message());
+        // Only a result with context frames needs its message built.
+        if (result.context().empty())
+            addMessage(result.message());
+        else
+            addMessage(result.fullMessage());
     }
 
     bool anyFailed() const noexcept
@@ -245,41 +461,511 @@ public:
         return _anySucceeded;
     }
 
+    bool deduplicates() const noexcept
+    {
+        return _deduplicating;
+    }
+
+    // Empty when the collector deduplicates, see messageCounts().
     const std::list<std::string>& messages() const noexcept
     {
         return _messages;
     }
 
+    // Distinct messages in the order they were first seen.
+    const std::vector<MessageCount>& messageCounts() const noexcept
+    {
+        return _messageCounts;
+    }
+
+    size_t droppedMessageCount() const noexcept
+    {
+        return _droppedMessageCount;
+    }
+
+private:
+    void addMessage(std::string_view message)
+    {
+        if (message.empty())
+            return;
+
+        if (_deduplicating)
+            countMessage(message);
+        else
+            _messages.emplace_back(message);
+    }
+
+    void countMessage(std::string_view message)
+    {
+        auto it = _messageIndices.find(message);
+
+        if (it != _messageIndices.end())
+        {
+            ++_messageCounts[it->second].count;
+
+            return;
+        }
+
+        if (_messageCounts.size() >= _maxDistinctMessages)
+        {
+            ++_droppedMessageCount;
+
+            return;
+        }
+
+        auto stored = _arena.store(message);
+        _messageIndices.emplace(stored, _messageCounts.size());
+        _messageCounts.push_back({stored, 1});
+    }
+
+    void copyMessageCounts(const ResultCollector& other)
+    {
+        _arena.clear();
+        _messageIndices.clear();
+        _messageCounts.clear();
+        _messageCounts.reserve(other._messageCounts.size());
+
+        for (auto& entry : other._messageCounts)
+        {
+            auto stored = _arena.store(entry.message);
+            _messageIndices.emplace(stored, _messageCounts.size());
+            _messageCounts.push_back({stored, entry.count});
+        }
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    bool                                         _anySucceeded{};
+    bool                                         _anyFailed{};
+    std::list<std::string>                       _messages{};
+    bool                                         _deduplicating{};
+    size_t                                       _maxDistinctMessages{};
+    size_t                                       _droppedMessageCount{};
+    StringArena                                  _arena{};
+    std::unordered_map<std::string_view, size_t> _messageIndices{};
+    std::vector<MessageCount>                    _messageCounts{};
+
+#pragma endregion
+};
+
+class ResultBatch
+{
+#pragma region ____________________________ Types ______________________________
+
+public:
+    struct Failure
+    {
+        size_t           index;
+        std::string_view message;
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    // Every operation starts out succeeded.
+    ResultBatch(size_t size = 0)
+    {
+        reset(size);
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    ResultBatch(ResultBatch&& other)            = default;
+    ResultBatch& operator=(ResultBatch&& other) = default;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    ResultBatch(const ResultBatch& other)
+        : _size{other._size}
+        , _succeeded{other._succeeded}
+    {
+        copyMessages(other);
+    }
+
+    ResultBatch& operator=(const ResultBatch& other)
+    {
+        if (this == &other)
+            return *this;
+
+        _size      = other._size;
+        _succeeded = other._succeeded;
+        copyMessages(other);
+
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    void reset(size_t size)
+    {
+        _size = size;
+        _succeeded.assign((size + 63) / 64, ~uint64_t{});
+        _messages.clear();
+        _arena.clear();
+
+        if (size % 64 != 0)
+            _succeeded.back() = (uint64_t{1} << (size % 64)) - 1;
+    }
+
+    // Indices are not range checked, they must be less than size().
+    void setFailed(size_t index, std::string_view message = {})
+    {
+        _succeeded[index / 64] &= ~(uint64_t{1} << (index % 64));
+
+        auto it = _messages.begin() + findMessage(index);
+
+        if (message.empty())
+        {
+            if (it != _messages.end() && it->index == index)
+                _messages.erase(it);
+
+            return;
+        }
+
+        auto stored = _arena.store(message);
+
+        if (it != _messages.end() && it->index == index)
+            it->message = stored;
+        else
+            _messages.insert(it, {index, stored});
+    }
+
+    void setSucceeded(size_t index)
+    {
+        _succeeded[index / 64] |= uint64_t{1} << (index % 64);
+
+        auto it = _messages.begin() + findMessage(index);
+
+        if (it != _messages.end() && it->index == index)
+            _messages.erase(it);
+    }
+
+    void set(size_t index, const Result& result)
+    {
+        if (!result.failed())
+            setSucceeded(index);
+        else if (result.context().empty())
+            setFailed(index, result.message());
+        else
+            setFailed(index, result.fullMessage());
+    }
+
+    bool succeeded(size_t index) const noexcept
+    {
+        return (_succeeded[index / 64] >> (index % 64)) & 1;
+    }
+
+    bool failed(size_t index) const noexcept
+    {
+        return !succeeded(index);
+    }
+
+    // Empty for succeeded operations and failures without a message.
+    std::string_view message(size_t index) const noexcept
+    {
+        auto position = findMessage(index);
+
+        return position < _messages.size() && _messages[position].index == index
+                 ? _messages[position].message
+                 : std::string_view{};
+    }
+
+    Result result(size_t index) const
+    {
+        return Result{succeeded(index), std::string{message(index)}};
+    }
+
+    bool allSucceeded() const noexcept
+    {
+        for (size_t i = 0; i + 1 < _succeeded.size(); ++i)
+            if (~_succeeded[i] != 0)
+                return false;
+
+        return _succeeded.empty() || _succeeded.back() == lastWordMask();
+    }
+
+    size_t countFailed() const noexcept
+    {
+        size_t succeededCount{};
+
+        for (auto word : _succeeded)
+            succeededCount += std::popcount(word);
+
+        return _size - succeededCount;
+    }
+
+    // Calls callback(index, message) for every failure in index order.
+    template<typename TCallback>
+    void forEachFailure(TCallback&& callback) const
+    {
+        auto nextMessage = _messages.begin();
+
+        for (size_t word = 0; word < _succeeded.size(); ++word)
+        {
+            auto failedBits = ~_succeeded[word];
+
+            if (word + 1 == _succeeded.size())
+                failedBits &= lastWordMask();
+
+            while (failedBits != 0)
+            {
+                auto index = word * 64 + std::countr_zero(failedBits);
+                failedBits &= failedBits - 1;
+
+                while (nextMessage != _messages.end() &&
+                       nextMessage->index < index)
+                    ++nextMessage;
+
+                if (nextMessage != _messages.end() &&
+                    nextMessage->index == index)
+                    callback(index, nextMessage->message);
+                else
+                    callback(index, std::string_view{});
+            }
+        }
+    }
+
+    std::vector<Failure> failures() const
+    {
+        std::vector<Failure> result;
+        result.reserve(countFailed());
+
+        forEachFailure([&result](size_t index, std::string_view message)
+                       { result.push_back({index, message}); });
+
+        return result;
+    }
+
+private:
+    uint64_t lastWordMask() const noexcept
+    {
+        return _size % 64 == 0 ? ~uint64_t{}
+                               : (uint64_t{1} << (_size % 64)) - 1;
+    }
+
+    // Position of the first message whose index is not less than index.
+    size_t findMessage(size_t index) const noexcept
+    {
+        // Batches are usually filled in index order, so appending is the
+        // common case.
+        if (_messages.empty() || _messages.back().index < index)
+            return _messages.size();
+
+        auto it = std::lower_bound(_messages.begin(),
+                                   _messages.end(),
+                                   index,
+                                   [](const Failure& failure, size_t key)
+                                   { return failure.index < key; });
+
+        return it - _messages.begin();
+    }
+
+    void copyMessages(const ResultBatch& other)
+    {
+        _arena.clear();
+        _messages.clear();
+        _messages.reserve(other._messages.size());
+
+        for (auto& failure : other._messages)
+            _messages.push_back({failure.index, _arena.store(failure.message)});
+    }
+
 #pragma endregion
 
 #pragma region ____________________________ Fields _____________________________
 
 private:
-    bool                   _anySucceeded{};
-    bool                   _anyFailed{};
-    std::list<std::string> _messages{};
+    size_t                _size{};
+    std::vector<uint64_t> _succeeded{};
+    StringArena           _arena{};
+    std::vector<Failure>  _messages{};
 
 #pragma endregion
 };
 
+template<typename TStatus>
+concept DenseStatus = std::is_enum_v<std::remove_cvref_t<TStatus>> ||
+    std::is_integral_v<std::remove_cvref_t<TStatus>>;
+
 template<typename TStatus>
 class StatusActionMapper
 {
+#pragma region ____________________________ Types ______________________________
+
+private:
+    using Key   = std::remove_cvref_t<TStatus>;
+    using Entry = std::pair<Key, Delegate<void(void)>>;
+
+#pragma endregion
+
 #pragma region ___________________________ Methods _____________________________
 
 public:
-    StatusActionMapper<TStatus>& bind(TStatus                   status,
-                                      std::function<void(void)> action)
+    StatusActionMapper<TStatus>& bind(TStatus              status,
+                                      Delegate<void(void)> action)
     {
-        _map[std::forward<TStatus>(status)] = std::move(action);
+        auto it = lowerBound(status);
+
+        if (it != _entries.end() && !(status < it->first))
+            it->second = std::move(action);
+        else
+            _entries.emplace(
+                it, std::forward<TStatus>(status), std::move(action));
 
         return *this;
     }
 
-    void execute(const std::remove_cvref_t<TStatus>& status)
+    void execute(const Key& status)
     {
-        if (_map.contains(status))
-            _map[status]();
+        auto it = lowerBound(status);
+
+        if (it != _entries.end() && !(status < it->first))
+            it->second();
+    }
+
+private:
+    typename std::vector<Entry>::iterator lowerBound(const Key& status)
+    {
+        return std::lower_bound(
+            _entries.begin(),
+            _entries.end(),
+            status,
+            [](const Entry& entry, const Key& key)
+            { return entry.first < key; });
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    // Kept sorted by status; bindings are rare compared to lookups.
+    std::vector<Entry> _entries{};
+
+#pragma endregion
+};
+
+template<typename TStatus>
+    requires DenseStatus<TStatus>
+class StatusActionMapper<TStatus>
+{
+#pragma region ____________________________ Types ______________________________
+
+private:
+    using Key         = std::remove_cvref_t<TStatus>;
+    using SparseEntry = std::pair<long long, Delegate<void(void)>>;
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    StatusActionMapper<TStatus>& bind(TStatus              status,
+                                      Delegate<void(void)> action)
+    {
+        auto value = toInteger(status);
+
+        if (_actions.empty())
+        {
+            _first = value;
+            _actions.resize(1);
+        }
+        else if (value < _first)
+        {
+            if (_first - value + _actions.size() > maxDenseSize)
+                return bindSparse(value, std::move(action));
+
+            _actions.insert(_actions.begin(), _first - value, nullptr);
+            _first = value;
+        }
+        else if (value - _first >= static_cast<long long>(_actions.size()))
+        {
+            if (value - _first + 1 > static_cast<long long>(maxDenseSize))
+                return bindSparse(value, std::move(action));
+
+            _actions.resize(value - _first + 1);
+        }
+
+        _actions[value - _first] = std::move(action);
+
+        return *this;
+    }
+
+    void execute(const Key& status)
+    {
+        auto value  = toInteger(status);
+        auto offset = static_cast<unsigned long long>(value) -
+                      static_cast<unsigned long long>(_first);
+
+        if (offset < _actions.size())
+        {
+            if (_actions[offset])
+                _actions[offset]();
+
+            return;
+        }
+
+        if (_sparse.empty())
+            return;
+
+        auto it = std::lower_bound(
+            _sparse.begin(),
+            _sparse.end(),
+            value,
+            [](const SparseEntry& entry, long long key)
+            { return entry.first < key; });
+
+        if (it != _sparse.end() && it->first == value)
+            it->second();
+    }
+
+private:
+    static constexpr size_t maxDenseSize = 1024;
+
+    static long long toInteger(const Key& status) noexcept
+    {
+        if constexpr (std::is_enum_v<Key>)
+            return static_cast<long long>(
+                static_cast<std::underlying_type_t<Key>>(status));
+        else
+            return static_cast<long long>(status);
+    }
+
+    StatusActionMapper<TStatus>& bindSparse(long long            value,
+                                            Delegate<void(void)> action)
+    {
+        auto it = std::lower_bound(
+            _sparse.begin(),
+            _sparse.end(),
+            value,
+            [](const SparseEntry& entry, long long key)
+            { return entry.first < key; });
+
+        if (it != _sparse.end() && it->first == value)
+            it->second = std::move(action);
+        else
+            _sparse.emplace(it, value, std::move(action));
+
+        return *this;
     }
 
 #pragma endregion
@@ -287,7 +973,11 @@ public:
 #pragma region ____________________________ Fields _____________________________
 
 private:
-    std::map<TStatus, std::function<void(void)>> _map{};
+    // Statuses within maxDenseSize of each other index _actions directly,
+    // outliers fall back to the sorted _sparse table.
+    long long                         _first{};
+    std::vector<Delegate<void(void)>> _actions{};
+    std::vector<SparseEntry>          _sparse{};
 
 #pragma endregion
 };
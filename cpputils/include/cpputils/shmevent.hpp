@@ -0,0 +1,413 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "event.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace cu
+{
+
+// Broadcasts events of a trivially copyable type to every process that
+// opened the channel. Events live in a ring inside a named shared memory
+// object; each cell is a seqlock, so readers never block writers.
+//
+// Every process reads at its own pace and delivers what it read to its
+// local listeners from poll(). A reader that falls a whole ring behind
+// skips to the oldest event still available and counts what it lost.
+// Publishers may run concurrently but must not lap each other.
+template<typename T>
+class ShmEventChannel
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Shared memory events must be trivially copyable.");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                      std::atomic<uint32_t>::is_always_lock_free,
+                  "Shared memory channels need lock-free atomics.");
+
+#pragma region ____________________________ Types ______________________________
+
+private:
+    // "cputils1", marks an initialized channel.
+    static constexpr uint64_t channelMagic = 0x6370'7574'696c'7331;
+
+    struct Header
+    {
+        std::atomic<uint64_t> magic{};
+        uint64_t              capacity{};
+        uint64_t              eventSize{};
+
+        // Next position to publish to.
+        alignas(64) std::atomic<uint64_t> tail{};
+
+        // Bumped after every publish, readers sleep on it.
+        alignas(64) std::atomic<uint32_t> wakeups{};
+        std::atomic<uint32_t> sleepers{};
+    };
+
+    // Holds 2p + 1 while position p is being written and 2p + 2 once it
+    // is complete.
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence{};
+        T                     event;
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    ~ShmEventChannel()
+    {
+        if (nullptr != _header)
+            ::munmap(_header, _mappingSize);
+    }
+
+private:
+    ShmEventChannel() = default;
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    ShmEventChannel(ShmEventChannel<T>&& other) noexcept
+        : _header{std::exchange(other._header, nullptr)}
+        , _cells{other._cells}
+        , _mappingSize{other._mappingSize}
+        , _readPosition{other._readPosition}
+        , _droppedCount{other._droppedCount}
+        , _handler{std::move(other._handler)}
+    {
+    }
+
+    ShmEventChannel<T>& operator=(ShmEventChannel<T>&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        if (nullptr != _header)
+            ::munmap(_header, _mappingSize);
+
+        _header       = std::exchange(other._header, nullptr);
+        _cells        = other._cells;
+        _mappingSize  = other._mappingSize;
+        _readPosition = other._readPosition;
+        _droppedCount = other._droppedCount;
+        _handler      = std::move(other._handler);
+
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    ShmEventChannel(const ShmEventChannel<T>& other) = delete;
+    ShmEventChannel<T>& operator=(const ShmEventChannel<T>& other) = delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    void operator+=(EventListener<const T&>& listener)
+    {
+        _handler += listener;
+    }
+
+    void operator-=(EventListener<const T&>& listener)
+    {
+        _handler -= listener;
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Static _____________________________
+
+public:
+    // Creates a new shared memory object under name. An existing object
+    // with the same name is unlinked first rather than truncated, so
+    // processes that still map it keep a valid, if orphaned, channel.
+    // capacity is rounded up to a power of two.
+    static ShmEventChannel<T> create(const std::string& name, size_t capacity)
+    {
+        capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+
+        unlink(name);
+
+        auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+        if (-1 == fd)
+            throwSystemError("shm_open");
+
+        auto size = mappingSize(capacity);
+
+        if (-1 == ::ftruncate(fd, static_cast<off_t>(size)))
+        {
+            auto error = errno;
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throwSystemError("ftruncate", error);
+        }
+
+        ShmEventChannel<T> channel;
+        channel.map(fd, size);
+
+        auto header       = ::new (channel._header) Header{};
+        header->capacity  = capacity;
+        header->eventSize = sizeof(T);
+
+        for (size_t i = 0; i < capacity; ++i)
+            ::new (&channel._cells[i].sequence) std::atomic<uint64_t>{};
+
+        header->magic.store(channelMagic, std::memory_order_release);
+
+        return channel;
+    }
+
+    // Opens a channel made by create(). Only events published after this
+    // call are delivered.
+    static ShmEventChannel<T> open(const std::string& name)
+    {
+        auto fd = ::shm_open(name.c_str(), O_RDWR, 0);
+
+        if (-1 == fd)
+            throwSystemError("shm_open");
+
+        struct stat info;
+
+        if (-1 == ::fstat(fd, &info))
+        {
+            auto error = errno;
+            ::close(fd);
+            throwSystemError("fstat", error);
+        }
+
+        ShmEventChannel<T> channel;
+        channel.map(fd, static_cast<size_t>(info.st_size));
+
+        auto header = channel._header;
+
+        if (channel._mappingSize < sizeof(Header) ||
+            channelMagic != header->magic.load(std::memory_order_acquire) ||
+            sizeof(T) != header->eventSize ||
+            channel._mappingSize != mappingSize(header->capacity))
+            throw std::runtime_error("Shared memory object is not a channel "
+                                     "of this event type.");
+
+        channel._readPosition = header->tail.load(std::memory_order_acquire);
+
+        return channel;
+    }
+
+    static void unlink(const std::string& name)
+    {
+        if (-1 == ::shm_unlink(name.c_str()) && ENOENT != errno)
+            throwSystemError("shm_unlink");
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    EventConnection subscribe(EventListener<const T&>& listener)
+    {
+        return _handler.subscribe(listener);
+    }
+
+    void unsubscribe(EventConnection connection)
+    {
+        _handler.unsubscribe(connection);
+    }
+
+    size_t capacity() const noexcept
+    {
+        return _header->capacity;
+    }
+
+    // Events this process skipped because it fell a whole ring behind.
+    uint64_t droppedCount() const noexcept
+    {
+        return _droppedCount;
+    }
+
+    void publish(const T& event)
+    {
+        auto position = _header->tail.fetch_add(1, std::memory_order_relaxed);
+        auto& cell    = cellAt(position);
+
+        cell.sequence.store(2 * position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&cell.event, &event, sizeof(T));
+        cell.sequence.store(2 * position + 2, std::memory_order_release);
+
+        _header->wakeups.fetch_add(1, std::memory_order_seq_cst);
+
+        if (0 != _header->sleepers.load(std::memory_order_seq_cst))
+            futex(FUTEX_WAKE, INT32_MAX, nullptr);
+    }
+
+    // Delivers up to maxEvents published events to the local listeners
+    // and returns how many were delivered.
+    size_t poll(size_t maxEvents = static_cast<size_t>(-1))
+    {
+        size_t delivered = 0;
+        T      event;
+
+        while (delivered < maxEvents && read(event))
+        {
+            _handler(event);
+            ++delivered;
+        }
+
+        return delivered;
+    }
+
+    // Blocks until an unread event may be available or timeout passed.
+    // Returns false on timeout.
+    bool wait(std::chrono::nanoseconds timeout)
+    {
+        auto wakeups = _header->wakeups.load(std::memory_order_seq_cst);
+
+        if (hasUnread())
+            return true;
+
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            timeout);
+        timespec remaining{
+            static_cast<time_t>(seconds.count()),
+            static_cast<long>((timeout - seconds).count())};
+
+        _header->sleepers.fetch_add(1, std::memory_order_seq_cst);
+        futex(FUTEX_WAIT, wakeups, &remaining);
+        _header->sleepers.fetch_sub(1, std::memory_order_seq_cst);
+
+        return hasUnread();
+    }
+
+private:
+    static size_t mappingSize(size_t capacity) noexcept
+    {
+        return sizeof(Header) + capacity * sizeof(Cell);
+    }
+
+    [[noreturn]] static void throwSystemError(const char* what,
+                                              int         error = errno)
+    {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    void map(int fd, size_t size)
+    {
+        auto address =
+            ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        auto error = errno;
+        ::close(fd);
+
+        if (MAP_FAILED == address)
+            throwSystemError("mmap", error);
+
+        _header      = static_cast<Header*>(address);
+        _cells       = reinterpret_cast<Cell*>(_header + 1);
+        _mappingSize = size;
+    }
+
+    Cell& cellAt(uint64_t position) const noexcept
+    {
+        return _cells[position & (_header->capacity - 1)];
+    }
+
+    bool hasUnread() const noexcept
+    {
+        return _header->tail.load(std::memory_order_acquire) != _readPosition;
+    }
+
+    void futex(int operation, uint32_t value, const timespec* timeout)
+    {
+        ::syscall(SYS_futex,
+                  reinterpret_cast<uint32_t*>(&_header->wakeups),
+                  operation,
+                  value,
+                  timeout,
+                  nullptr,
+                  0);
+    }
+
+    bool read(T& event)
+    {
+        while (true)
+        {
+            auto& cell     = cellAt(_readPosition);
+            auto  expected = 2 * _readPosition + 2;
+            auto  before   = cell.sequence.load(std::memory_order_acquire);
+
+            // Not published yet, or still being written.
+            if (before < expected)
+                return false;
+
+            if (before == expected)
+            {
+                std::memcpy(&event, &cell.event, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (cell.sequence.load(std::memory_order_relaxed) == before)
+                {
+                    ++_readPosition;
+
+                    return true;
+                }
+            }
+
+            // Overwritten by a later lap, skip to the oldest event left.
+            auto tail     = _header->tail.load(std::memory_order_acquire);
+            auto capacity = _header->capacity;
+            auto oldest   = tail > capacity ? tail - capacity : 0;
+
+            // A writer claims its position before touching the cell, so
+            // the tail is always past this position here.
+            _droppedCount += oldest - _readPosition;
+            _readPosition  = oldest;
+        }
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    Header*                _header{};
+    Cell*                  _cells{};
+    size_t                 _mappingSize{};
+    uint64_t               _readPosition{};
+    uint64_t               _droppedCount{};
+    EventHandler<const T&> _handler{};
+
+#pragma endregion
+};
+
+}
+
+#endif
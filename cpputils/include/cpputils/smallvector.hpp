@@ -0,0 +1,205 @@
+#pragma once
+
+#include <type_traits>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <cstddef>
+
+namespace cu
+{
+
+// Keeps up to TCapacity elements inline and only allocates past that.
+// Restricted to trivially copyable types so growing and copying are plain
+// memory copies.
+template<typename T, size_t TCapacity>
+    requires std::is_trivially_copyable_v<T>
+class SmallVector
+{
+#pragma region _________________________ Constructors __________________________
+
+public:
+    SmallVector() = default;
+    ~SmallVector() = default;
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    SmallVector(SmallVector<T, TCapacity>&& other) noexcept
+        : _size{other._size}
+        , _capacity{other._capacity}
+        , _heap{std::move(other._heap)}
+    {
+        if (!_heap)
+            std::memcpy(_inline, other._inline, _size * sizeof(T));
+
+        other._size     = 0;
+        other._capacity = TCapacity;
+    }
+
+    SmallVector<T, TCapacity>& operator=(
+        SmallVector<T, TCapacity>&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        _size     = other._size;
+        _capacity = other._capacity;
+        _heap     = std::move(other._heap);
+
+        if (!_heap)
+            std::memcpy(_inline, other._inline, _size * sizeof(T));
+
+        other._size     = 0;
+        other._capacity = TCapacity;
+
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    SmallVector(const SmallVector<T, TCapacity>& other)
+    {
+        append(other.data(), other._size);
+    }
+
+    SmallVector<T, TCapacity>& operator=(const SmallVector<T, TCapacity>& other)
+    {
+        if (this == &other)
+            return *this;
+
+        clear();
+        append(other.data(), other._size);
+
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    T& operator[](size_t index) noexcept
+    {
+        return data()[index];
+    }
+
+    const T& operator[](size_t index) const noexcept
+    {
+        return data()[index];
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    bool empty() const noexcept
+    {
+        return 0 == _size;
+    }
+
+    bool isInline() const noexcept
+    {
+        return !_heap;
+    }
+
+    T* data() noexcept
+    {
+        return _heap ? _heap.get() : reinterpret_cast<T*>(_inline);
+    }
+
+    const T* data() const noexcept
+    {
+        return _heap ? _heap.get() : reinterpret_cast<const T*>(_inline);
+    }
+
+    T* begin() noexcept
+    {
+        return data();
+    }
+
+    T* end() noexcept
+    {
+        return data() + _size;
+    }
+
+    const T* begin() const noexcept
+    {
+        return data();
+    }
+
+    const T* end() const noexcept
+    {
+        return data() + _size;
+    }
+
+    T& back() noexcept
+    {
+        return data()[_size - 1];
+    }
+
+    void push_back(const T& value)
+    {
+        // value may live in this vector, copy it before growing.
+        auto copy = value;
+
+        if (_size == _capacity)
+            grow(_capacity * 2);
+
+        std::memcpy(data() + _size, &copy, sizeof(T));
+        ++_size;
+    }
+
+    void pop_back() noexcept
+    {
+        --_size;
+    }
+
+    void clear() noexcept
+    {
+        _size = 0;
+    }
+
+private:
+    void append(const T* values, size_t count)
+    {
+        if (_size + count > _capacity)
+            grow(std::max(_size + count, _capacity * 2));
+
+        std::memcpy(data() + _size, values, count * sizeof(T));
+        _size += count;
+    }
+
+    void grow(size_t capacity)
+    {
+        auto heap = std::make_unique_for_overwrite<T[]>(capacity);
+        std::memcpy(heap.get(), data(), _size * sizeof(T));
+        _heap     = std::move(heap);
+        _capacity = capacity;
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    size_t               _size{};
+    size_t               _capacity{TCapacity};
+    std::unique_ptr<T[]> _heap{};
+    alignas(T) std::byte _inline[sizeof(T) * TCapacity];
+
+#pragma endregion
+};
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace cu
+{
+
+// Calls a member function on an object with static storage duration, so
+// that it can be named in a template argument.
+template<auto& TInstance, auto TMember>
+struct Bound
+{
+    template<typename... TArgs>
+    void operator()(TArgs&&... args) const
+    {
+        std::invoke(TMember, TInstance, std::forward<TArgs>(args)...);
+    }
+};
+
+template<auto& TInstance, auto TMember>
+inline constexpr Bound<TInstance, TMember> bound{};
+
+// An event whose listeners are fixed at compile time: function pointers,
+// captureless lambdas or bound members. Emitting is a sequence of direct
+// calls the compiler can inline, there is nothing to register at runtime.
+// Every listener receives the arguments as lvalues, in declaration order.
+template<auto... TListeners>
+class StaticEvent
+{
+#pragma region ____________________________ Types ______________________________
+
+public:
+    template<auto... TMore>
+    using With = StaticEvent<TListeners..., TMore...>;
+
+#pragma endregion
+
+#pragma region ___________________________ Operators ___________________________
+
+public:
+    template<typename... TArgs>
+    void operator()(TArgs&&... args) const
+    {
+        emit(args...);
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Static _____________________________
+
+public:
+    static constexpr size_t listenerCount = sizeof...(TListeners);
+
+    template<typename... TArgs>
+    static void emit(TArgs&&... args)
+    {
+        (std::invoke(TListeners, args...), ...);
+    }
+
+#pragma endregion
+};
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+namespace cu
+{
+
+class StringArena
+{
+#pragma region _________________________ Constructors __________________________
+
+public:
+    StringArena(size_t blockSize = 4096)
+        : _blockSize{blockSize}
+    {
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    StringArena(StringArena&& other) = default;
+    StringArena& operator=(StringArena&& other) = default;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    // Views handed out by an arena point into its own blocks, so a copy has
+    // nothing it could share. Callers re-store what they need.
+    StringArena(const StringArena& other)            = delete;
+    StringArena& operator=(const StringArena& other) = delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    // The returned view stays valid until the arena is cleared or destroyed.
+    std::string_view store(std::string_view text)
+    {
+        if (text.empty())
+            return {};
+
+        if (text.size() > _blockSize)
+        {
+            // Oversized strings get a dedicated block so the current block
+            // keeps its remaining space.
+            auto block = std::make_unique<char[]>(text.size());
+            std::memcpy(block.get(), text.data(), text.size());
+            _largeBlocks.push_back(std::move(block));
+            _bytesUsed += text.size();
+
+            return {_largeBlocks.back().get(), text.size()};
+        }
+
+        if (_blocks.empty() || _blockSize - _blockOffset < text.size())
+        {
+            _blocks.push_back(std::make_unique<char[]>(_blockSize));
+            _blockOffset = 0;
+        }
+
+        auto destination = _blocks.back().get() + _blockOffset;
+        std::memcpy(destination, text.data(), text.size());
+        _blockOffset += text.size();
+        _bytesUsed += text.size();
+
+        return {destination, text.size()};
+    }
+
+    void clear() noexcept
+    {
+        _blocks.clear();
+        _largeBlocks.clear();
+        _blockOffset = 0;
+        _bytesUsed   = 0;
+    }
+
+    size_t bytesUsed() const noexcept
+    {
+        return _bytesUsed;
+    }
+
+    size_t blockCount() const noexcept
+    {
+        return _blocks.size() + _largeBlocks.size();
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    size_t                               _blockSize;
+    size_t                               _blockOffset{};
+    size_t                               _bytesUsed{};
+    std::vector<std::unique_ptr<char[]>> _blocks{};
+    std::vector<std::unique_ptr<char[]>> _largeBlocks{};
+
+#pragma endregion
+};
+
+}
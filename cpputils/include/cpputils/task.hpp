@@ -0,0 +1,946 @@
+#pragma once
+
+#include "delegate.hpp"
+#include "result.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cu
+{
+
+class ThreadPool
+{
+#pragma region ____________________________ Types ______________________________
+
+public:
+    class Job
+    {
+    public:
+        virtual ~Job() noexcept = default;
+
+        virtual void run() = 0;
+    };
+
+private:
+    template<typename TCallable>
+    class CallableJob : public Job
+    {
+        TCallable _callable;
+
+    public:
+        CallableJob(TCallable callable)
+            : _callable{std::move(callable)}
+        {
+        }
+
+        void run() override
+        {
+            std::unique_ptr<CallableJob<TCallable>> self{this};
+            _callable();
+        }
+    };
+
+    struct Worker
+    {
+        std::mutex       mutex{};
+        std::deque<Job*> jobs{};
+        std::thread      thread{};
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    ThreadPool(size_t threadCount = std::thread::hardware_concurrency())
+    {
+        if (0 == threadCount)
+            threadCount = 1;
+
+        for (size_t i = 0; i < threadCount; ++i)
+            _workers.push_back(std::make_unique<Worker>());
+
+        for (size_t i = 0; i < threadCount; ++i)
+            _workers[i]->thread = std::thread{[this, i] { workerLoop(i); }};
+    }
+
+    // Runs every queued job before returning.
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock{_sleepMutex};
+            _stopping = true;
+        }
+
+        _wake.notify_all();
+
+        for (auto& worker : _workers)
+            worker->thread.join();
+    }
+
+#pragma endregion
+
+#pragma region ________________________ Move Semantics _________________________
+
+public:
+    ThreadPool(ThreadPool&& other)            = delete;
+    ThreadPool& operator=(ThreadPool&& other) = delete;
+
+#pragma endregion
+
+#pragma region ________________________ Copy Semantics _________________________
+
+public:
+    ThreadPool(const ThreadPool& other)            = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    size_t threadCount() const noexcept
+    {
+        return _workers.size();
+    }
+
+    // The pool does not own the job, it must stay alive until run() is
+    // called. Jobs enqueued from a worker go to that worker's own queue,
+    // idle workers steal from the others.
+    void enqueue(Job& job)
+    {
+        auto& worker = this == _currentPool
+                         ? *_workers[_currentWorker]
+                         : *_workers[_nextWorker++ % _workers.size()];
+
+        {
+            std::lock_guard lock{worker.mutex};
+            worker.jobs.push_back(&job);
+            ++_queuedJobs;
+        }
+
+        if (_sleepingWorkers > 0)
+        {
+            std::lock_guard lock{_sleepMutex};
+            _wake.notify_one();
+        }
+    }
+
+    template<typename TCallable>
+    void submit(TCallable callable)
+    {
+        enqueue(*new CallableJob<TCallable>(std::move(callable)));
+    }
+
+    // Runs one queued job on the calling thread. Used by waiters so that
+    // blocking on a task from a worker keeps the pool busy instead of
+    // stalling it.
+    bool runPendingJob()
+    {
+        auto job = tryPop(this == _currentPool ? _currentWorker : 0);
+
+        if (nullptr == job)
+            return false;
+
+        job->run();
+
+        return true;
+    }
+
+    bool isWorkerThread() const noexcept
+    {
+        return this == _currentPool;
+    }
+
+    // Calls fn(first, last) for consecutive ranges of at most chunkSize
+    // indices that together cover [0, count). The calling thread takes
+    // ranges as well and idle workers steal the jobs that claim them.
+    // Returns once every range ran and rethrows the first exception fn
+    // threw; the other ranges still run.
+    void parallelFor(size_t                             count,
+                     size_t                             chunkSize,
+                     FunctionRef<void(size_t, size_t)> fn)
+    {
+        // Helpers that start after the last chunk was claimed only touch
+        // this state, which is why it is shared rather than on our stack.
+        struct State
+        {
+            FunctionRef<void(size_t, size_t)> fn;
+            size_t                            count{};
+            size_t                            chunkSize{};
+            size_t                            chunkCount{};
+            std::atomic<size_t>               nextChunk{};
+            std::atomic<size_t>               completedChunks{};
+            std::mutex                        errorMutex{};
+            std::exception_ptr                error{};
+
+            // Returns false once there is nothing left to claim.
+            bool runChunk()
+            {
+                auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+
+                if (chunk >= chunkCount)
+                    return false;
+
+                auto first = chunk * chunkSize;
+
+                try
+                {
+                    fn(first, std::min(first + chunkSize, count));
+                }
+                catch (...)
+                {
+                    std::lock_guard lock{errorMutex};
+
+                    if (!error)
+                        error = std::current_exception();
+                }
+
+                completedChunks.fetch_add(1, std::memory_order_acq_rel);
+
+                return true;
+            }
+        };
+
+        chunkSize  = std::max<size_t>(chunkSize, 1);
+        auto state = std::make_shared<State>(fn, count, chunkSize);
+        state->chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        auto helpers = std::min(threadCount(),
+                                state->chunkCount > 0 ? state->chunkCount - 1
+                                                      : size_t{0});
+
+        for (size_t i = 0; i < helpers; ++i)
+            submit(
+                [state]
+                {
+                    while (state->runChunk())
+                    {
+                    }
+                });
+
+        while (state->runChunk())
+        {
+        }
+
+        while (state->completedChunks.load(std::memory_order_acquire) <
+               state->chunkCount)
+            if (!runPendingJob())
+                std::this_thread::yield();
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+
+private:
+    Job* tryPop(size_t preferred)
+    {
+        {
+            auto&           own = *_workers[preferred];
+            std::lock_guard lock{own.mutex};
+
+            if (!own.jobs.empty())
+            {
+                auto job = own.jobs.back();
+                own.jobs.pop_back();
+                --_queuedJobs;
+
+                return job;
+            }
+        }
+
+        for (size_t i = 1; i < _workers.size(); ++i)
+        {
+            auto& victim = *_workers[(preferred + i) % _workers.size()];
+
+            std::lock_guard lock{victim.mutex};
+
+            if (!victim.jobs.empty())
+            {
+                auto job = victim.jobs.front();
+                victim.jobs.pop_front();
+                --_queuedJobs;
+
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void workerLoop(size_t index)
+    {
+        _currentPool   = this;
+        _currentWorker = index;
+
+        while (true)
+        {
+            if (auto job = tryPop(index))
+            {
+                job->run();
+
+                continue;
+            }
+
+            std::unique_lock lock{_sleepMutex};
+
+            // Registering as a sleeper before checking the queue count
+            // pairs with enqueue(), which counts first and checks sleepers
+            // second, so a wakeup can not be lost in between.
+            ++_sleepingWorkers;
+            _wake.wait(lock, [this] { return _stopping || _queuedJobs > 0; });
+            --_sleepingWorkers;
+
+            if (_stopping && 0 == _queuedJobs)
+                return;
+        }
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    std::vector<std::unique_ptr<Worker>> _workers{};
+    std::atomic<size_t>                  _queuedJobs{};
+    std::atomic<size_t>                  _sleepingWorkers{};
+    std::atomic<size_t>                  _nextWorker{};
+    std::mutex                           _sleepMutex{};
+    std::condition_variable              _wake{};
+    bool                                 _stopping{};
+
+    static inline thread_local ThreadPool* _currentPool{};
+    static inline thread_local size_t      _currentWorker{};
+
+#pragma endregion
+};
+
+template<typename T>
+struct IsDataResult : std::false_type
+{
+};
+
+template<typename TData>
+struct IsDataResult<DataResult<TData>> : std::true_type
+{
+};
+
+// Values continuations can short-circuit on. Status has no notion of
+// failure, so Status values are passed on like any other value.
+template<typename T>
+concept ResultLike = std::same_as<T, Result> || IsDataResult<T>::value;
+
+// Constraint conjunctions stop at the first unsatisfied check, so data()
+// is only looked at for DataResult.
+template<typename TCallable, typename T>
+concept InvocableWithData =
+    IsDataResult<T>::value &&
+    std::is_invocable_v<TCallable&, decltype(std::declval<T&>().data())>;
+
+template<ResultLike TResult>
+TResult
+failureOf(std::string message)
+{
+    if constexpr (std::same_as<TResult, Result>)
+        return Result{false, std::move(message)};
+    else
+        return TResult{std::move(message)};
+}
+
+// Keeps the failure's context frames, unlike failureOf().
+template<ResultLike TResult>
+TResult
+failureFrom(Result failure)
+{
+    if constexpr (std::same_as<TResult, Result>)
+        return failure;
+    else
+        return TResult::propagate(std::move(failure));
+}
+
+class TaskContinuation
+{
+public:
+    TaskContinuation* next{};
+
+    virtual ~TaskContinuation() noexcept = default;
+
+    virtual void onReady() = 0;
+};
+
+template<typename T>
+class TaskState
+{
+#pragma region _________________________ Constructors __________________________
+
+public:
+    TaskState(ThreadPool* pool = nullptr)
+        : _pool{pool}
+    {
+    }
+
+    virtual ~TaskState() noexcept = default;
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    ThreadPool* pool() const noexcept
+    {
+        return _pool;
+    }
+
+    bool ready() const noexcept
+    {
+        return _ready.load(std::memory_order_acquire);
+    }
+
+    void wait() const
+    {
+        if (nullptr != _pool && _pool->isWorkerThread())
+        {
+            while (!ready())
+                if (!_pool->runPendingJob())
+                    std::this_thread::yield();
+
+            return;
+        }
+
+        _ready.wait(false, std::memory_order_acquire);
+    }
+
+    T& value()
+    {
+        wait();
+
+        if (_exception)
+            std::rethrow_exception(_exception);
+
+        return *_value;
+    }
+
+    const std::exception_ptr& exception() const noexcept
+    {
+        return _exception;
+    }
+
+    void complete(T value)
+    {
+        _value.emplace(std::move(value));
+        publish();
+    }
+
+    void fail(std::exception_ptr exception)
+    {
+        _exception = std::move(exception);
+        publish();
+    }
+
+    // Failures of result-like tasks are reported as failed results, other
+    // task types rethrow from value().
+    template<typename TCallable>
+    void completeWith(TCallable&& callable)
+    {
+        try
+        {
+            complete(callable());
+        }
+        catch (const std::exception& e)
+        {
+            if constexpr (ResultLike<T>)
+                complete(failureOf<T>(e.what()));
+            else
+                fail(std::current_exception());
+        }
+        catch (...)
+        {
+            if constexpr (ResultLike<T>)
+                complete(failureOf<T>("Unknown error."));
+            else
+                fail(std::current_exception());
+        }
+    }
+
+    void addContinuation(TaskContinuation& continuation)
+    {
+        auto head = _continuations.load(std::memory_order_acquire);
+
+        do
+        {
+            if (head == completedMarker())
+            {
+                continuation.onReady();
+
+                return;
+            }
+
+            continuation.next = head;
+        } while (!_continuations.compare_exchange_weak(
+            head,
+            &continuation,
+            std::memory_order_acq_rel,
+            std::memory_order_acquire));
+    }
+
+private:
+    static TaskContinuation* completedMarker() noexcept
+    {
+        static char marker;
+
+        return reinterpret_cast<TaskContinuation*>(&marker);
+    }
+
+    void publish()
+    {
+        _ready.store(true, std::memory_order_release);
+        _ready.notify_all();
+
+        auto continuation = _continuations.exchange(completedMarker(),
+                                                    std::memory_order_acq_rel);
+
+        while (nullptr != continuation)
+        {
+            auto next = continuation->next;
+            continuation->onReady();
+            continuation = next;
+        }
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    ThreadPool*                    _pool;
+    std::optional<T>               _value{};
+    std::exception_ptr             _exception{};
+    std::atomic<bool>              _ready{};
+    std::atomic<TaskContinuation*> _continuations{};
+
+#pragma endregion
+};
+
+template<typename T>
+class Task;
+
+// What then() produces: the callable receives the data of a DataResult,
+// the task's value itself, or nothing, whichever it accepts first.
+template<typename T, typename TCallable>
+struct ContinuationResult
+{
+    static auto select()
+    {
+        if constexpr (InvocableWithData<TCallable, T>)
+            return std::type_identity<std::invoke_result_t<
+                TCallable&,
+                decltype(std::declval<T&>().data())>>{};
+        else if constexpr (std::is_invocable_v<TCallable&, T&>)
+            return std::type_identity<std::invoke_result_t<TCallable&, T&>>{};
+        else
+            return std::type_identity<std::invoke_result_t<TCallable&>>{};
+    }
+
+    using type = typename decltype(select())::type;
+};
+
+template<typename T, typename TCallable>
+class SpawnedTaskState
+    : public TaskState<T>
+    , public ThreadPool::Job
+{
+    TCallable                     _callable;
+    std::shared_ptr<TaskState<T>> _self{};
+
+public:
+    SpawnedTaskState(ThreadPool& pool, TCallable callable)
+        : TaskState<T>(&pool)
+        , _callable{std::move(callable)}
+    {
+    }
+
+    void start(std::shared_ptr<TaskState<T>> self)
+    {
+        _self = std::move(self);
+        this->pool()->enqueue(*this);
+    }
+
+    void run() override
+    {
+        auto self = std::move(_self);
+        this->completeWith(_callable);
+    }
+};
+
+template<typename TResult, typename T, typename TCallable>
+class ContinuationTaskState
+    : public TaskState<TResult>
+    , public ThreadPool::Job
+    , public TaskContinuation
+{
+    std::shared_ptr<TaskState<T>>       _parent;
+    TCallable                           _callable;
+    std::shared_ptr<TaskState<TResult>> _self{};
+
+public:
+    ContinuationTaskState(std::shared_ptr<TaskState<T>> parent,
+                          TCallable                     callable)
+        : TaskState<TResult>(parent->pool())
+        , _parent{std::move(parent)}
+        , _callable{std::move(callable)}
+    {
+    }
+
+    void start(std::shared_ptr<TaskState<TResult>> self)
+    {
+        _self = std::move(self);
+        _parent->addContinuation(*this);
+    }
+
+    void onReady() override
+    {
+        if (nullptr == this->pool())
+            run();
+        else
+            this->pool()->enqueue(*this);
+    }
+
+    void run() override
+    {
+        auto self   = std::move(_self);
+        auto parent = std::move(_parent);
+
+        if (parent->exception())
+            return this->fail(parent->exception());
+
+        auto& value = parent->value();
+
+        if constexpr (ResultLike<T>)
+        {
+            if (value.failed())
+            {
+                static_assert(ResultLike<TResult>,
+                              "A continuation of a result-like task must "
+                              "return Result or DataResult.");
+
+                return this->complete(failureFrom<TResult>(value));
+            }
+        }
+
+        this->completeWith([this, &value] { return invoke(value); });
+    }
+
+private:
+    TResult invoke(T& value)
+    {
+        if constexpr (InvocableWithData<TCallable, T>)
+            return _callable(value.data());
+        else if constexpr (std::is_invocable_v<TCallable&, T&>)
+            return _callable(value);
+        else
+            return _callable();
+    }
+};
+
+template<typename T>
+class Task
+{
+#pragma region _________________________ Constructors __________________________
+
+public:
+    Task(std::shared_ptr<TaskState<T>> state)
+        : _state{std::move(state)}
+    {
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Static _____________________________
+
+public:
+    static Task<T> completed(T value)
+    {
+        auto state = std::make_shared<TaskState<T>>();
+        state->complete(std::move(value));
+
+        return Task<T>{std::move(state)};
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    bool ready() const noexcept
+    {
+        return _state->ready();
+    }
+
+    // Called from a pool worker, waiting runs other queued jobs instead of
+    // blocking the worker.
+    void wait() const
+    {
+        _state->wait();
+    }
+
+    T& get()
+    {
+        return _state->value();
+    }
+
+    // The callable receives the data of a succeeded DataResult, the result
+    // itself, or nothing. It is skipped when the result failed, and the
+    // failure message is passed on instead.
+    template<typename TCallable>
+    auto then(TCallable callable)
+    {
+        using TResult = typename ContinuationResult<T, TCallable>::type;
+        using TState  = ContinuationTaskState<TResult, T, TCallable>;
+
+        auto state = std::make_shared<TState>(_state, std::move(callable));
+        state->start(state);
+
+        return Task<TResult>{std::move(state)};
+    }
+
+    const std::shared_ptr<TaskState<T>>& state() const noexcept
+    {
+        return _state;
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    std::shared_ptr<TaskState<T>> _state;
+
+#pragma endregion
+};
+
+template<typename TCallable>
+auto
+spawn(ThreadPool& pool, TCallable callable)
+{
+    using T      = std::invoke_result_t<TCallable&>;
+    using TState = SpawnedTaskState<T, TCallable>;
+
+    auto state = std::make_shared<TState>(pool, std::move(callable));
+    state->start(state);
+
+    return Task<T>{std::move(state)};
+}
+
+template<typename TResult, typename T, bool TAny>
+class TaskGroupState : public TaskState<TResult>
+{
+#pragma region ____________________________ Types ______________________________
+
+private:
+    struct Member : TaskContinuation
+    {
+        TaskGroupState<TResult, T, TAny>* owner{};
+        size_t                            index{};
+
+        void onReady() override
+        {
+            owner->memberReady(index);
+        }
+    };
+
+#pragma endregion
+
+#pragma region _________________________ Constructors __________________________
+
+public:
+    TaskGroupState(std::vector<Task<T>> tasks)
+        : TaskState<TResult>(tasks.empty() ? nullptr : tasks[0].state()->pool())
+        , _tasks{std::move(tasks)}
+        , _members(_tasks.size())
+        , _remaining{_tasks.size()}
+    {
+    }
+
+#pragma endregion
+
+#pragma region ___________________________ Methods _____________________________
+
+public:
+    // The group keeps itself alive until every member reported, even if it
+    // resolved early, because members still hold pointers into it.
+    void start(std::shared_ptr<TaskGroupState<TResult, T, TAny>> self)
+    {
+        if (_tasks.empty())
+        {
+            if constexpr (TAny)
+                this->complete(failureOf<TResult>("No tasks to wait for."));
+            else
+                this->complete(makeResult());
+
+            return;
+        }
+
+        _self = std::move(self);
+
+        for (size_t i = 0; i < _tasks.size(); ++i)
+        {
+            _members[i].owner = this;
+            _members[i].index = i;
+        }
+
+        for (size_t i = 0; i < _tasks.size(); ++i)
+            _tasks[i].state()->addContinuation(_members[i]);
+    }
+
+private:
+    // A member that decides the outcome on its own resolves before it
+    // counts itself out. Once the last member counts itself out, every
+    // deciding member has therefore resolved already, and the last one only
+    // has to resolve when none did.
+    void memberReady(size_t index)
+    {
+        auto& state = *_tasks[index].state();
+
+        if (!_resolved.load(std::memory_order_acquire))
+        {
+            bool succeeded = !state.exception() && state.value().succeeded();
+
+            if constexpr (TAny)
+            {
+                if (succeeded)
+                    resolve([&] { return std::move(state.value()); });
+            }
+            else
+            {
+                if (!succeeded)
+                    resolve([&] { return failure(state); });
+            }
+        }
+
+        if (1 != _remaining.fetch_sub(1, std::memory_order_acq_rel))
+            return;
+
+        if constexpr (TAny)
+            resolve([&] { return failure(state); });
+        else
+            resolve([&] { return makeResult(); });
+
+        _self.reset();
+    }
+
+    template<typename TMake>
+    void resolve(TMake&& make)
+    {
+        if (!_resolved.exchange(true, std::memory_order_acq_rel))
+            this->complete(make());
+    }
+
+    static TResult failure(TaskState<T>& state)
+    {
+        if (!state.exception())
+            return failureFrom<TResult>(state.value());
+
+        try
+        {
+            std::rethrow_exception(state.exception());
+        }
+        catch (const std::exception& e)
+        {
+            return failureOf<TResult>(e.what());
+        }
+        catch (...)
+        {
+            return failureOf<TResult>("Unknown error.");
+        }
+    }
+
+    TResult makeResult()
+    {
+        if constexpr (IsDataResult<T>::value)
+        {
+            using TData = std::remove_cvref_t<decltype(_tasks[0].get().data())>;
+
+            std::vector<TData> values;
+            values.reserve(_tasks.size());
+
+            for (auto& task : _tasks)
+                values.push_back(std::move(task.get().data()));
+
+            return TResult{std::move(values)};
+        }
+        else
+            return TResult{};
+    }
+
+#pragma endregion
+
+#pragma region ____________________________ Fields _____________________________
+
+private:
+    std::vector<Task<T>>                              _tasks;
+    std::vector<Member>                               _members;
+    std::atomic<size_t>                               _remaining;
+    std::atomic<bool>                                 _resolved{};
+    std::shared_ptr<TaskGroupState<TResult, T, TAny>> _self{};
+
+#pragma endregion
+};
+
+// Resolves with every member's data once all succeeded, or with the first
+// failure as soon as it happens. The members' data is moved out, so the
+// given tasks should not be read afterwards.
+template<typename TData>
+Task<DataResult<std::vector<TData>>>
+whenAll(std::vector<Task<DataResult<TData>>> tasks)
+{
+    static_assert(!std::is_reference_v<TData>,
+                  "whenAll can not collect references.");
+
+    using TState = TaskGroupState<DataResult<std::vector<TData>>,
+                                  DataResult<TData>,
+                                  false>;
+
+    auto state = std::make_shared<TState>(std::move(tasks));
+    state->start(state);
+
+    return {std::move(state)};
+}
+
+inline Task<Result>
+whenAll(std::vector<Task<Result>> tasks)
+{
+    using TState = TaskGroupState<Result, Result, false>;
+
+    auto state = std::make_shared<TState>(std::move(tasks));
+    state->start(state);
+
+    return {std::move(state)};
+}
+
+// Resolves with the first member that succeeds, or with the last failure
+// when none did. The winning result is moved out of its task.
+template<ResultLike T>
+Task<T>
+whenAny(std::vector<Task<T>> tasks)
+{
+    using TState = TaskGroupState<T, T, true>;
+
+    auto state = std::make_shared<TState>(std::move(tasks));
+    state->start(state);
+
+    return {std::move(state)};
+}
+
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <cpputils/ai/behaviourtree.hpp>
+#include <string>
 
 using namespace cu::ai;
 
@@ -142,4 +143,59 @@ TEST(behaviour_tree_tests, can_chain_different_node_types)
 
     EXPECT_EQ(expectedStatus, actualStatus);
     EXPECT_EQ(expectedIterationCount, actualIterationCount);
-}
\ No newline at end of file
+}
+
+TEST(behaviour_tree_tests, run_to_completion_sequence_resolves_in_one_tick)
+{
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+    seq->setTickMode(BTTickMode::runToCompletion);
+    seq->createChild<BTAction>(successAction);
+    seq->createChild<BTAction>(successAction);
+    seq->createChild<BTAction>(successAction);
+    seq->createChild<BTAction>(successAction);
+
+    EXPECT_EQ(BTStatus::success, tree.tick());
+}
+
+TEST(behaviour_tree_tests, run_to_completion_fallback_resolves_in_one_tick)
+{
+    BehaviourTree tree;
+    auto          fallback = tree.createRoot<BTFallback>();
+    fallback->setTickMode(BTTickMode::runToCompletion);
+    fallback->createChild<BTAction>(failureAction);
+    fallback->createChild<BTAction>(failureAction);
+    fallback->createChild<BTAction>(failureAction);
+
+    EXPECT_EQ(BTStatus::failure, tree.tick());
+}
+
+TEST(behaviour_tree_tests, run_to_completion_stops_at_running_child)
+{
+    int           count = 0;
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+    seq->setTickMode(BTTickMode::runToCompletion);
+    seq->createChild<BTAction>(successAction);
+    seq->createChild<BTAction>(
+        [&count]
+        { return 2 > ++count ? BTStatus::running : BTStatus::success; });
+    seq->createChild<BTAction>(successAction);
+
+    EXPECT_EQ(BTStatus::running, tree.tick());
+    EXPECT_EQ(BTStatus::success, tree.tick());
+    EXPECT_EQ(2, count);
+}
+
+TEST(behaviour_tree_tests, action_accepts_large_captures)
+{
+    std::string first{"a string long enough to skip small buffers"};
+    std::string second{"and another one to go past the capacity"};
+
+    BehaviourTree tree;
+    tree.createRoot<BTAction>(
+        [first, second]
+        { return first == second ? BTStatus::failure : BTStatus::success; });
+
+    EXPECT_EQ(BTStatus::success, tree.tick());
+}
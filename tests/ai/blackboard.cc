@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <cpputils/ai/blackboard.hpp>
+#include <cpputils/ai/flatbehaviourtree.hpp>
+#include <memory>
+#include <string>
+
+using namespace cu::ai;
+
+TEST(blackboard_tests, starts_with_initial_values)
+{
+    auto layout = std::make_shared<BlackboardLayout>();
+    auto health = layout->add<float>(100.f);
+    auto name   = layout->add<std::string>("guard");
+    auto alert  = layout->add<bool>();
+
+    Blackboard blackboard{layout};
+
+    EXPECT_EQ(3, layout->keyCount());
+    EXPECT_FLOAT_EQ(100.f, blackboard[health]);
+    EXPECT_EQ("guard", blackboard[name]);
+    EXPECT_FALSE(blackboard[alert]);
+}
+
+TEST(blackboard_tests, places_keys_at_aligned_offsets)
+{
+    BlackboardLayout layout;
+    auto             flag  = layout.add<char>();
+    auto             value = layout.add<double>();
+    auto             count = layout.add<int>();
+
+    EXPECT_EQ(0, flag.offset());
+    EXPECT_EQ(8, value.offset());
+    EXPECT_EQ(16, count.offset());
+    EXPECT_EQ(20, layout.size());
+}
+
+TEST(blackboard_tests, copies_are_independent)
+{
+    auto layout = std::make_shared<BlackboardLayout>();
+    auto name   = layout->add<std::string>("guard");
+
+    Blackboard original{layout};
+    Blackboard copy{original};
+    copy[name] = "archer";
+
+    Blackboard moved{std::move(copy)};
+    original = moved;
+
+    EXPECT_EQ("archer", original[name]);
+    EXPECT_EQ("archer", moved[name]);
+    EXPECT_EQ(nullptr, copy.layout());
+}
+
+TEST(blackboard_tests, every_agent_gets_its_own_blackboard)
+{
+    auto layout = std::make_shared<BlackboardLayout>();
+    auto ammo   = layout->add<int>(2);
+
+    BehaviourTree tree;
+    tree.createRoot<BTAgentAction>(
+        [ammo](BTAgent& agent)
+        {
+            auto& left = agent.blackboard()[ammo];
+
+            if (0 == left)
+                return BTStatus::failure;
+
+            --left;
+
+            return BTStatus::success;
+        });
+
+    auto    flat = std::make_shared<const FlatBehaviourTree>(tree, layout);
+    BTAgent first{flat};
+    BTAgent second{flat};
+
+    EXPECT_EQ(BTStatus::success, first.tick());
+    EXPECT_EQ(BTStatus::success, first.tick());
+    EXPECT_EQ(BTStatus::failure, first.tick());
+    EXPECT_EQ(BTStatus::success, second.tick());
+    EXPECT_EQ(1, second.blackboard()[ammo]);
+}
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <cpputils/ai/btcoroutine.hpp>
+#include <cpputils/ai/btworld.hpp>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace cu::ai;
+
+namespace cu::ai::tests
+{
+
+// Compiles a tree whose only node runs body.
+std::shared_ptr<const FlatBehaviourTree>
+coroutineTree(Delegate<BTCoroutine(BTAgent&)> body)
+{
+    BehaviourTree tree;
+    tree.createRoot<BTCoroutineAction>(std::move(body));
+
+    return std::make_shared<const FlatBehaviourTree>(tree);
+}
+
+// Bumps the int behind the agent on both sides of a suspension.
+BTCoroutine countTwice(BTAgent& agent)
+{
+    ++*agent.userData<int>();
+    co_await BTNextTick{};
+    ++*agent.userData<int>();
+    co_return BTStatus::success;
+}
+
+}
+
+using namespace cu::ai::tests;
+
+TEST(bt_coroutine_tests, reports_running_at_every_suspension)
+{
+    int     steps = 0;
+    BTAgent agent{coroutineTree(
+        [&steps](BTAgent&) -> BTCoroutine
+        {
+            ++steps;
+            co_await BTNextTick{};
+            ++steps;
+            co_await BTNextTick{};
+            ++steps;
+            co_return BTStatus::success;
+        })};
+
+    EXPECT_EQ(BTStatus::running, agent.tick());
+    EXPECT_EQ(1, steps);
+    EXPECT_EQ(BTStatus::running, agent.tick());
+    EXPECT_EQ(BTStatus::success, agent.tick());
+    EXPECT_EQ(3, steps);
+
+    // The next tick starts over.
+    EXPECT_EQ(BTStatus::running, agent.tick());
+    EXPECT_EQ(4, steps);
+}
+
+TEST(bt_coroutine_tests, waits_until_condition_holds)
+{
+    bool    open = false;
+    BTAgent agent{coroutineTree(
+        [&open](BTAgent&) -> BTCoroutine
+        {
+            co_await BTWaitUntil{[&open] { return open; }};
+            co_return BTStatus::success;
+        })};
+
+    EXPECT_EQ(BTStatus::running, agent.tick());
+    EXPECT_EQ(BTStatus::running, agent.tick());
+    open = true;
+    EXPECT_EQ(BTStatus::success, agent.tick());
+}
+
+TEST(bt_coroutine_tests, sleeps_by_the_tick_time_of_the_agent)
+{
+    using namespace std::chrono_literals;
+
+    int     steps = 0;
+    BTAgent agent{coroutineTree(
+        [&steps](BTAgent&) -> BTCoroutine
+        {
+            ++steps;
+            co_await BTSleep{20ms};
+            ++steps;
+            co_return BTStatus::failure;
+        })};
+    auto start = BTClock::time_point{};
+
+    EXPECT_EQ(BTStatus::running, agent.tick(start));
+    EXPECT_TRUE(agent.isSuspended());
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 19ms));
+    EXPECT_EQ(1, steps);
+    EXPECT_EQ(BTStatus::failure, agent.tick(start + 20ms));
+    EXPECT_EQ(2, steps);
+}
+
+TEST(bt_coroutine_tests, awaits_subtree_status)
+{
+    BehaviourTree subtree;
+    auto          seq = subtree.createRoot<BTSequence>();
+    seq->createChild<BTAction>([] { return BTStatus::success; });
+    seq->createChild<BTAction>([] { return BTStatus::failure; });
+
+    auto    result = BTStatus::running;
+    BTAgent agent{coroutineTree(
+        [&](BTAgent&) -> BTCoroutine
+        {
+            result = co_await BTSubtree{subtree};
+            co_return BTStatus::success;
+        })};
+
+    EXPECT_EQ(BTStatus::running, agent.tick());
+    EXPECT_EQ(BTStatus::success, agent.tick());
+    EXPECT_EQ(BTStatus::failure, result);
+}
+
+TEST(bt_coroutine_tests, rethrows_body_exceptions_and_restarts)
+{
+    int     runs = 0;
+    BTAgent agent{coroutineTree(
+        [&runs](BTAgent&) -> BTCoroutine
+        {
+            if (1 == ++runs)
+                throw std::runtime_error("failed");
+
+            co_return BTStatus::success;
+        })};
+
+    EXPECT_THROW(agent.tick(), std::runtime_error);
+    EXPECT_EQ(BTStatus::success, agent.tick());
+}
+
+TEST(bt_coroutine_tests, frame_pool_reuses_released_frames)
+{
+    auto first = BTFramePool::allocate(100);
+    BTFramePool::deallocate(first, 100);
+    auto second = BTFramePool::allocate(120);
+
+    EXPECT_EQ(first, second);
+
+    BTFramePool::deallocate(second, 120);
+}
+
+TEST(bt_coroutine_tests, agents_keep_their_own_runs)
+{
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+    seq->setTickMode(BTTickMode::runToCompletion);
+    seq->createChild<BTCoroutineAction>(countTwice);
+    seq->createChild<BTAction>([] { return BTStatus::success; });
+
+    auto shared = std::make_shared<const FlatBehaviourTree>(tree);
+    int  firstCount{}, secondCount{};
+
+    BTAgent first{shared, &firstCount};
+    BTAgent second{shared, &secondCount};
+
+    EXPECT_EQ(BTStatus::running, first.tick());
+    EXPECT_EQ(BTStatus::running, second.tick());
+    EXPECT_EQ(BTStatus::success, first.tick());
+    EXPECT_EQ(2, firstCount);
+    EXPECT_EQ(1, secondCount);
+}
+
+TEST(bt_coroutine_tests, ticks_standalone_with_its_own_run)
+{
+    int           steps = 0;
+    BehaviourTree tree;
+    tree.createRoot<BTCoroutineAction>(
+        [&steps]() -> BTCoroutine
+        {
+            ++steps;
+            co_await BTNextTick{};
+            ++steps;
+            co_return BTStatus::success;
+        });
+
+    auto    shared = std::make_shared<const FlatBehaviourTree>(tree);
+    BTAgent agent{shared};
+
+    EXPECT_EQ(BTStatus::running, tree.tick());
+    EXPECT_EQ(BTStatus::running, agent.tick());
+    EXPECT_EQ(BTStatus::success, tree.tick());
+    EXPECT_EQ(3, steps);
+    EXPECT_EQ(BTStatus::success, agent.tick());
+    EXPECT_EQ(4, steps);
+}
+
+TEST(bt_coroutine_tests, moved_agent_starts_over)
+{
+    int     count = 0;
+    BTAgent agent{coroutineTree(countTwice), &count};
+
+    EXPECT_EQ(BTStatus::running, agent.tick());
+
+    BTAgent moved{std::move(agent)};
+
+    EXPECT_EQ(BTStatus::running, moved.tick());
+    EXPECT_EQ(2, count);
+    EXPECT_EQ(BTStatus::success, moved.tick());
+}
+
+TEST(bt_coroutine_tests, agents_on_a_pool_run_concurrently)
+{
+    auto             shared = coroutineTree(countTwice);
+    std::vector<int> counts(256);
+    BTWorld          world;
+
+    for (auto& count : counts)
+        world.add(shared, &count);
+
+    cu::ThreadPool pool{4};
+
+    EXPECT_EQ(256, world.tick(pool, 8)[0].running);
+    EXPECT_EQ(256, world.tick(pool, 8)[0].success);
+
+    for (auto count : counts)
+        ASSERT_EQ(2, count);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <cpputils/ai/btworld.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace cu::ai;
+
+namespace cu::ai::tests
+{
+
+// A sequence of count agent actions that bump the int behind the agent.
+std::shared_ptr<const FlatBehaviourTree> countingTree(int count)
+{
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+
+    for (int i = 0; i < count; ++i)
+        seq->createChild<BTAgentAction>(
+            [](BTAgent& agent)
+            {
+                ++*agent.userData<int>();
+
+                return BTStatus::success;
+            });
+
+    return std::make_shared<const FlatBehaviourTree>(tree);
+}
+
+}
+
+using namespace cu::ai::tests;
+
+TEST(bt_world_tests, groups_agents_by_tree)
+{
+    auto    shortTree = countingTree(1);
+    auto    longTree  = countingTree(2);
+    int     counts[3]{};
+    BTWorld world;
+
+    auto first  = world.add(shortTree, &counts[0]);
+    auto second = world.add(longTree, &counts[1]);
+    auto third  = world.add(shortTree, &counts[2]);
+
+    EXPECT_EQ(2, world.groupCount());
+    EXPECT_EQ(3, world.agentCount());
+    EXPECT_EQ(first.group, third.group);
+    EXPECT_NE(first.group, second.group);
+
+    auto& results = world.tick();
+
+    ASSERT_EQ(2, results.size());
+    EXPECT_EQ(shortTree.get(), results[0].tree);
+    EXPECT_EQ(2, results[0].success);
+    EXPECT_EQ(longTree.get(), results[1].tree);
+    EXPECT_EQ(1, results[1].running);
+    EXPECT_EQ(BTStatus::success, world.status(third));
+    EXPECT_EQ(BTStatus::running, world.status(second));
+}
+
+TEST(bt_world_tests, ticks_every_agent_on_a_pool)
+{
+    auto             shortTree = countingTree(1);
+    auto             longTree  = countingTree(3);
+    std::vector<int> counts(1000);
+    BTWorld          world;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+        world.add(3 == i % 4 ? longTree : shortTree, &counts[i]);
+
+    cu::ThreadPool pool{4};
+
+    for (int tick = 0; tick < 3; ++tick)
+    {
+        auto& results = world.tick(pool, 16);
+
+        ASSERT_EQ(2, results.size());
+        EXPECT_EQ(750, results[0].success);
+        EXPECT_EQ(tick < 2 ? 250 : 0, results[1].running);
+        EXPECT_EQ(tick < 2 ? 0 : 250, results[1].success);
+    }
+
+    for (auto count : counts)
+        ASSERT_EQ(3, count);
+}
+
+TEST(bt_world_tests, rethrows_agent_exceptions_after_the_tick)
+{
+    BehaviourTree tree;
+    tree.createRoot<BTAgentAction>(
+        [](BTAgent& agent) -> BTStatus
+        {
+            if (nullptr == agent.userData<int>())
+                throw std::runtime_error("no data");
+
+            ++*agent.userData<int>();
+
+            return BTStatus::success;
+        });
+
+    auto             shared = std::make_shared<const FlatBehaviourTree>(tree);
+    std::vector<int> counts(64);
+    BTWorld          world;
+
+    for (auto& count : counts)
+        world.add(shared, &count);
+
+    world.add(shared);
+
+    cu::ThreadPool pool{2};
+
+    EXPECT_THROW(world.tick(pool, 4), std::runtime_error);
+
+    for (auto count : counts)
+        ASSERT_EQ(1, count);
+}
+
+TEST(bt_world_tests, counts_suspended_agents)
+{
+    BehaviourTree tree;
+    tree.createRoot<BTAgentAction>(
+        [](BTAgent& agent)
+        {
+            ++*agent.userData<int>();
+            agent.waitForSignal();
+
+            return BTStatus::running;
+        });
+
+    auto             shared = std::make_shared<const FlatBehaviourTree>(tree);
+    std::vector<int> counts(8);
+    BTWorld          world;
+
+    for (auto& count : counts)
+        world.add(shared, &count);
+
+    cu::ThreadPool pool{2};
+
+    EXPECT_EQ(8, world.tick(pool, 2)[0].suspended);
+
+    world.agent(BTAgentId{0, 3}).signal();
+    auto& results = world.tick();
+
+    EXPECT_EQ(8, results[0].running);
+    EXPECT_EQ(8, results[0].suspended);
+    EXPECT_EQ(1, counts[2]);
+    EXPECT_EQ(2, counts[3]);
+}
@@ -0,0 +1,313 @@
+#include <gtest/gtest.h>
+#include <cpputils/ai/flatbehaviourtree.hpp>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cu::ai;
+
+namespace cu::ai::tests
+{
+
+// Returns its statuses in a loop and logs its name on every tick.
+struct ScriptedAction
+{
+    std::vector<BTStatus> statuses;
+    std::string*          log;
+    char                  name;
+    size_t                next = 0;
+
+    BTStatus operator()()
+    {
+        *log += name;
+
+        return statuses[next++ % statuses.size()];
+    }
+};
+
+class CountingNode : public BTNode
+{
+public:
+    int tickCount = 0;
+
+    BTStatus tick() override
+    {
+        ++tickCount;
+
+        return BTStatus::success;
+    }
+};
+
+// A sequence that succeeds right away, without overriding kind().
+class ShortcutSequence : public BTSequence
+{
+public:
+    BTStatus tick() override
+    {
+        return BTStatus::success;
+    }
+};
+
+// Builds the same mixed tree every time, logging into log.
+void buildTree(BehaviourTree& tree,
+               std::string&   log,
+               BTTickMode     mode = BTTickMode::singleStep)
+{
+    auto s = BTStatus::success;
+    auto f = BTStatus::failure;
+    auto r = BTStatus::running;
+
+    auto root     = tree.createRoot<BTSequence>();
+    auto fallback = root->createChild<BTFallback>();
+    auto nested   = fallback->createChild<BTSequence>();
+    root->setTickMode(mode);
+    nested->setTickMode(mode);
+
+    nested->createChild<BTAction>(ScriptedAction{{s, f}, &log, 'a'});
+    nested->createChild<BTAction>(ScriptedAction{{r, s, f}, &log, 'b'});
+    fallback->createChild<BTAction>(ScriptedAction{{f, f, s}, &log, 'c'});
+    root->createChild<BTAction>(ScriptedAction{{r, s}, &log, 'd'});
+    root->createChild<BTFallback>();
+}
+
+}
+
+using namespace cu::ai::tests;
+
+TEST(flat_behaviour_tree_tests, ticks_like_the_source_tree)
+{
+    std::string   expectedLog;
+    BehaviourTree expectedTree;
+    buildTree(expectedTree, expectedLog);
+
+    std::string   actualLog;
+    BehaviourTree sourceTree;
+    buildTree(sourceTree, actualLog);
+    FlatBehaviourTree flat{sourceTree};
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(expectedTree.tick(), flat.tick()) << "tick " << i;
+
+    EXPECT_EQ(expectedLog, actualLog);
+}
+
+TEST(flat_behaviour_tree_tests, runs_to_completion_like_the_source_tree)
+{
+    std::string   expectedLog;
+    BehaviourTree expectedTree;
+    buildTree(expectedTree, expectedLog, BTTickMode::runToCompletion);
+
+    std::string   actualLog;
+    BehaviourTree sourceTree;
+    buildTree(sourceTree, actualLog, BTTickMode::runToCompletion);
+    FlatBehaviourTree flat{sourceTree};
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(expectedTree.tick(), flat.tick()) << "tick " << i;
+
+    EXPECT_EQ(expectedLog, actualLog);
+}
+
+TEST(flat_behaviour_tree_tests, sequence_advances_one_child_per_tick)
+{
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+
+    for (int i = 0; i < 4; ++i)
+        seq->createChild<BTAction>([] { return BTStatus::success; });
+
+    FlatBehaviourTree flat{tree};
+
+    EXPECT_EQ(BTStatus::running, flat.tick());
+    EXPECT_EQ(BTStatus::running, flat.tick());
+    EXPECT_EQ(BTStatus::running, flat.tick());
+    EXPECT_EQ(BTStatus::success, flat.tick());
+}
+
+TEST(flat_behaviour_tree_tests, lays_out_siblings_next_to_each_other)
+{
+    BehaviourTree tree;
+    auto          root  = tree.createRoot<BTFallback>();
+    auto          left  = root->createChild<BTSequence>();
+    auto          right = root->createChild<BTSequence>();
+    left->createChild<BTAction>([] { return BTStatus::success; });
+    right->createChild<BTAction>([] { return BTStatus::success; });
+    right->createChild<BTAction>([] { return BTStatus::success; });
+
+    FlatBehaviourTree flat{tree};
+
+    ASSERT_EQ(7, flat.nodeCount());
+    EXPECT_EQ(BTNodeKind::tree, flat.node(0).kind);
+    EXPECT_EQ(BTNodeKind::fallback, flat.node(1).kind);
+    EXPECT_EQ(2, flat.node(1).firstChild);
+    EXPECT_EQ(2, flat.node(1).childCount);
+    EXPECT_EQ(4, flat.node(2).firstChild);
+    EXPECT_EQ(1, flat.node(2).childCount);
+    EXPECT_EQ(5, flat.node(3).firstChild);
+    EXPECT_EQ(2, flat.node(3).childCount);
+    EXPECT_EQ(3, flat.node(6).parent);
+}
+
+TEST(flat_behaviour_tree_tests, ticks_custom_nodes_of_the_source_tree)
+{
+    BehaviourTree tree;
+    auto          seq    = tree.createRoot<BTSequence>();
+    auto          custom = seq->createChild<CountingNode>();
+
+    FlatBehaviourTree flat{tree};
+
+    EXPECT_EQ(BTStatus::success, flat.tick());
+    EXPECT_EQ(1, custom->tickCount);
+}
+
+TEST(flat_behaviour_tree_tests, subclasses_of_built_in_nodes_keep_their_tick)
+{
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<ShortcutSequence>();
+    seq->createChild<BTAction>([] { return BTStatus::failure; });
+
+    FlatBehaviourTree flat{tree};
+
+    EXPECT_EQ(BTNodeKind::custom, flat.node(1).kind);
+    EXPECT_EQ(BTStatus::success, flat.tick());
+}
+
+TEST(flat_behaviour_tree_tests, empty_tree_fails)
+{
+    BehaviourTree     tree;
+    FlatBehaviourTree flat{tree};
+
+    EXPECT_EQ(BTStatus::failure, flat.tick());
+}
+
+TEST(flat_behaviour_tree_tests, reset_restarts_control_nodes)
+{
+    int           count = 0;
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+    seq->createChild<BTAction>([&count] { return ++count, BTStatus::success; });
+    seq->createChild<BTAction>([] { return BTStatus::failure; });
+
+    FlatBehaviourTree flat{tree};
+
+    EXPECT_EQ(BTStatus::running, flat.tick());
+    flat.reset();
+    EXPECT_EQ(BTStatus::running, flat.tick());
+    EXPECT_EQ(2, count);
+}
+
+TEST(flat_behaviour_tree_tests, agents_share_a_tree_with_their_own_progress)
+{
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+
+    for (int i = 0; i < 3; ++i)
+        seq->createChild<BTAgentAction>(
+            [](BTAgent& agent)
+            {
+                ++*agent.userData<int>();
+
+                return BTStatus::success;
+            });
+
+    auto shared = std::make_shared<const FlatBehaviourTree>(tree);
+    int  firstCount{}, secondCount{};
+
+    BTAgent first{shared, &firstCount};
+    BTAgent second{shared, &secondCount};
+
+    EXPECT_EQ(BTStatus::running, first.tick());
+    EXPECT_EQ(BTStatus::running, first.tick());
+    EXPECT_EQ(BTStatus::running, second.tick());
+    EXPECT_EQ(BTStatus::success, first.tick());
+    EXPECT_EQ(BTStatus::running, second.tick());
+
+    EXPECT_EQ(3, firstCount);
+    EXPECT_EQ(2, secondCount);
+    EXPECT_EQ(&first.tree(), &second.tree());
+}
+
+TEST(flat_behaviour_tree_tests, agent_actions_need_an_agent)
+{
+    BehaviourTree tree;
+    tree.createRoot<BTAgentAction>([](BTAgent&) { return BTStatus::success; });
+
+    FlatBehaviourTree flat{tree};
+
+    EXPECT_THROW(tree.tick(), std::runtime_error);
+    EXPECT_THROW(flat.tick(), std::runtime_error);
+}
+
+TEST(flat_behaviour_tree_tests, suspended_agents_skip_the_tree_until_woken)
+{
+    using namespace std::chrono_literals;
+
+    auto layout = std::make_shared<BlackboardLayout>();
+    auto target = layout->add<int>();
+    int  ticks  = 0;
+
+    BehaviourTree tree;
+    auto          seq = tree.createRoot<BTSequence>();
+    seq->createChild<BTAgentAction>(
+        [&ticks](BTAgent& agent)
+        {
+            if (1 == ++ticks)
+            {
+                agent.sleepFor(10ms);
+
+                return BTStatus::running;
+            }
+
+            return BTStatus::success;
+        });
+    seq->createChild<BTAgentAction>(
+        [&ticks, target](BTAgent& agent)
+        {
+            ++ticks;
+
+            if (0 == agent.blackboard()[target])
+            {
+                agent.waitFor(target);
+                agent.waitForSignal();
+
+                return BTStatus::running;
+            }
+
+            return BTStatus::success;
+        });
+
+    auto    flat = std::make_shared<const FlatBehaviourTree>(tree, layout);
+    BTAgent agent{flat};
+    auto    start = BTClock::time_point{};
+
+    EXPECT_EQ(BTStatus::running, agent.tick(start));
+    EXPECT_TRUE(agent.isSuspended());
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 5ms));
+    EXPECT_EQ(1, ticks);
+
+    // Wakes on the timer, then parks on the blackboard key or a signal.
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 10ms));
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 11ms));
+    EXPECT_EQ(3, ticks);
+
+    agent.blackboard()[target] = 1;
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 12ms));
+    EXPECT_EQ(3, ticks);
+
+    agent.signal();
+    EXPECT_EQ(BTStatus::success, agent.tick(start + 13ms));
+    EXPECT_EQ(4, ticks);
+
+    agent.reset();
+    ticks = 1;
+    agent.blackboard()[target] = 0;
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 14ms));
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 15ms));
+    EXPECT_EQ(BTStatus::running, agent.tick(start + 16ms));
+    EXPECT_EQ(3, ticks);
+
+    agent.blackboard().set(target, 2);
+    EXPECT_EQ(BTStatus::success, agent.tick(start + 17ms));
+    EXPECT_FALSE(agent.isSuspended());
+}
@@ -0,0 +1,147 @@
+#include <cpputils/coalescingevent.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace cu::coalescingevent::tests
+{
+struct Position
+{
+    int entity;
+    int x;
+};
+}
+
+using cu::coalescingevent::tests::Position;
+
+TEST(coalescingevent_tests, last_value_wins)
+{
+    cu::CoalescingEventHandler<int> event;
+    std::vector<int>                received;
+
+    cu::EventListener<const int&> listener(
+        [&received](int value) { received.push_back(value); });
+    event += listener;
+
+    event.post(1);
+    event.post(2);
+    event.post(3);
+
+    EXPECT_EQ(1, event.pendingCount());
+    EXPECT_EQ(2, event.coalescedCount());
+    EXPECT_EQ(1, event.flush());
+    EXPECT_EQ(std::vector<int>{3}, received);
+    EXPECT_EQ(0, event.flush());
+}
+
+TEST(coalescingevent_tests, merges_with_merge_function)
+{
+    cu::CoalescingEventHandler<int> event{
+        [](int& pending, const int& incoming) { pending += incoming; }};
+    int total{};
+
+    cu::EventListener<const int&> listener(
+        [&total](int value) { total = value; });
+    event += listener;
+
+    event.post(1);
+    event.post(2);
+    event.post(3);
+    event.flush();
+
+    EXPECT_EQ(6, total);
+}
+
+TEST(coalescingevent_tests, keeps_one_event_per_key)
+{
+    cu::CoalescingEventHandler<Position, int> event{
+        [](const Position& position) { return position.entity; }};
+    std::vector<int> received;
+
+    cu::EventListener<const Position&> listener(
+        [&received](const Position& position)
+        { received.push_back(position.entity * 100 + position.x); });
+    event += listener;
+
+    event.post({1, 10});
+    event.post({2, 20});
+    event.post({1, 11});
+    event.post({3, 30});
+    event.post({2, 21});
+
+    EXPECT_EQ(3, event.flush());
+    EXPECT_EQ((std::vector<int>{111, 221, 330}), received);
+}
+
+TEST(coalescingevent_tests, posts_during_flush_wait_for_next_flush)
+{
+    cu::CoalescingEventHandler<int> event;
+    int                             calls{};
+
+    cu::EventListener<const int&> listener(
+        [&](int value)
+        {
+            ++calls;
+
+            if (value < 3)
+                event.post(value + 1);
+        });
+    event += listener;
+
+    event.post(1);
+
+    EXPECT_EQ(1, event.flush());
+    EXPECT_EQ(1, calls);
+    EXPECT_EQ(1, event.pendingCount());
+}
+
+TEST(coalescingevent_tests, poll_respects_window)
+{
+    using namespace std::chrono_literals;
+    using Clock = cu::CoalescingEventHandler<int>::Clock;
+
+    cu::CoalescingEventHandler<int> event{nullptr, 10ms};
+    int                             calls{};
+
+    cu::EventListener<const int&> listener([&calls](int) { ++calls; });
+    event += listener;
+
+    auto start = Clock::now();
+
+    event.post(1);
+    EXPECT_EQ(1, event.poll(start));
+
+    event.post(2);
+    EXPECT_EQ(0, event.poll(start));
+    EXPECT_EQ(1, event.poll(start + 1h));
+    EXPECT_EQ(2, calls);
+}
+
+TEST(coalescingevent_tests, throwing_listener_does_not_block_later_flushes)
+{
+    cu::CoalescingEventHandler<Position, int> event{
+        [](const Position& position) { return position.entity; }};
+    std::vector<int> received;
+    bool             fail{true};
+
+    cu::EventListener<const Position&> listener(
+        [&](const Position& position)
+        {
+            if (fail)
+                throw std::runtime_error("listener failed");
+
+            received.push_back(position.entity);
+        });
+    event += listener;
+
+    event.post({1, 10});
+    event.post({2, 20});
+    EXPECT_THROW(event.flush(), std::runtime_error);
+
+    fail = false;
+    event.post({1, 11});
+
+    EXPECT_EQ(1, event.pendingCount());
+    EXPECT_EQ(1, event.flush());
+    EXPECT_EQ(std::vector<int>{1}, received);
+}
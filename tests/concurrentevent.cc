@@ -0,0 +1,168 @@
+#include <cpputils/concurrentevent.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(concurrentevent_tests, invokes_subscribed_callbacks)
+{
+    cu::ConcurrentEventHandler<int> event;
+    int                             sum{};
+
+    auto id = event.subscribe([&sum](int value) { sum += value; });
+    event.subscribe([&sum](int value) { sum += value * 10; });
+
+    event(2);
+
+    EXPECT_EQ(22, sum);
+    EXPECT_TRUE(event.unsubscribe(id));
+    EXPECT_FALSE(event.unsubscribe(id));
+
+    event(1);
+
+    EXPECT_EQ(32, sum);
+    EXPECT_EQ(1, event.listenerCount());
+}
+
+TEST(concurrentevent_tests, unsubscribed_callback_is_not_running_after_return)
+{
+    cu::ConcurrentEventHandler<> event;
+    std::atomic<bool>            stop{};
+    std::atomic<bool>            unsubscribed{};
+    std::atomic<int>             callsAfterUnsubscribe{};
+    std::atomic<int>             calls{};
+
+    auto id = event.subscribe(
+        [&]
+        {
+            ++calls;
+
+            if (unsubscribed)
+                ++callsAfterUnsubscribe;
+        });
+
+    std::vector<std::thread> emitters;
+
+    for (int i = 0; i < 8; ++i)
+        emitters.emplace_back(
+            [&]
+            {
+                while (!stop)
+                    event();
+            });
+
+    while (calls < 1000)
+        std::this_thread::yield();
+
+    event.unsubscribe(id);
+    unsubscribed = true;
+
+    for (int i = 0; i < 1000; ++i)
+        event();
+
+    stop = true;
+
+    for (auto& emitter : emitters)
+        emitter.join();
+
+    EXPECT_EQ(0, callsAfterUnsubscribe);
+}
+
+TEST(concurrentevent_tests, subscriptions_change_while_emitting)
+{
+    cu::ConcurrentEventHandler<int> event;
+    std::atomic<bool>               stop{};
+    std::atomic<long>               total{};
+
+    event.subscribe([&total](int value) { total += value; });
+
+    std::vector<std::thread> emitters;
+
+    for (int i = 0; i < 2; ++i)
+        emitters.emplace_back(
+            [&]
+            {
+                while (!stop)
+                    event(1);
+            });
+
+    while (0 == total)
+        std::this_thread::yield();
+
+    for (int i = 0; i < 20; ++i)
+    {
+        auto id = event.subscribe([&total](int value) { total += value; });
+        event.unsubscribe(id);
+    }
+
+    stop = true;
+
+    for (auto& emitter : emitters)
+        emitter.join();
+
+    EXPECT_GT(total, 0);
+    EXPECT_EQ(1, event.listenerCount());
+}
+
+TEST(concurrentevent_tests, can_unsubscribe_from_inside_callback)
+{
+    cu::ConcurrentEventHandler<> event;
+    int                          calls{};
+
+    cu::ConcurrentEventHandler<>::SubscriptionId id{};
+    id = event.subscribe(
+        [&]
+        {
+            ++calls;
+            event.unsubscribe(id);
+        });
+
+    event();
+    event();
+
+    EXPECT_EQ(1, calls);
+    EXPECT_EQ(0, event.listenerCount());
+}
+
+TEST(concurrentevent_tests, unsubscribing_from_another_handler_waits_for_it)
+{
+    cu::ConcurrentEventHandler<> outer;
+    cu::ConcurrentEventHandler<> inner;
+    std::atomic<bool>            stop{};
+    std::atomic<bool>            running{};
+    std::atomic<int>             calls{};
+    bool                         ranAfterUnsubscribe{};
+
+    auto id = inner.subscribe(
+        [&]
+        {
+            running = true;
+            ++calls;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            running = false;
+        });
+
+    outer.subscribe(
+        [&]
+        {
+            inner.unsubscribe(id);
+            ranAfterUnsubscribe = running;
+        });
+
+    std::thread emitter{[&]
+                        {
+                            while (!stop)
+                                inner();
+                        }};
+
+    while (calls < 3)
+        std::this_thread::yield();
+
+    outer();
+    stop = true;
+    emitter.join();
+
+    EXPECT_FALSE(ranAfterUnsubscribe);
+    EXPECT_EQ(0, inner.listenerCount());
+}
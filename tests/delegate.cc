@@ -0,0 +1,145 @@
+#include <cpputils/delegate.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+using namespace cu;
+
+static int
+twice(int value)
+{
+    return value * 2;
+}
+
+TEST(delegate_tests, default_constructed_delegate_is_empty)
+{
+    Delegate<void()> delegate;
+
+    EXPECT_FALSE(delegate);
+    EXPECT_THROW({ delegate(); }, std::bad_function_call);
+}
+
+TEST(delegate_tests, calls_lambda_with_captures)
+{
+    int                      offset{5};
+    Delegate<int(int, int)> delegate{[offset](int a, int b)
+                                      { return a + b + offset; }};
+
+    EXPECT_TRUE(delegate);
+    EXPECT_EQ(12, delegate(3, 4));
+}
+
+TEST(delegate_tests, calls_function_pointer)
+{
+    Delegate<int(int)> delegate{&twice};
+
+    EXPECT_EQ(8, delegate(4));
+}
+
+TEST(delegate_tests, calls_function_passed_by_name)
+{
+    Delegate<int(int)> delegate{twice};
+
+    EXPECT_EQ(8, delegate(4));
+}
+
+TEST(delegate_tests, null_function_pointer_gives_empty_delegate)
+{
+    int (*function)(int) = nullptr;
+    Delegate<int(int)> delegate{function};
+
+    EXPECT_FALSE(delegate);
+}
+
+TEST(delegate_tests, wraps_std_function)
+{
+    std::function<int(int)> function = [](int value) { return value + 1; };
+    Delegate<int(int)>      delegate{function};
+
+    EXPECT_EQ(2, delegate(1));
+}
+
+TEST(delegate_tests, copy_and_move_semantics_work)
+{
+    auto counter = std::make_shared<int>(0);
+
+    Delegate<void()> original{[counter] { ++*counter; }};
+    Delegate<void()> copied{original};
+    Delegate<void()> moved{std::move(original)};
+
+    copied();
+    moved();
+
+    EXPECT_FALSE(original);
+    EXPECT_EQ(2, *counter);
+    EXPECT_EQ(3, counter.use_count());
+
+    copied.reset();
+    moved = nullptr;
+
+    EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(delegate_tests, rejects_move_only_callables)
+{
+    auto moveOnly = [value = std::make_unique<int>(4)] { return *value; };
+    using MoveOnly = decltype(moveOnly);
+
+    EXPECT_FALSE((std::is_constructible_v<Delegate<int()>, MoveOnly>));
+    EXPECT_TRUE((std::is_constructible_v<Delegate<int()>, int (*)()>));
+}
+
+TEST(delegate_tests, keeps_large_callables_on_the_heap)
+{
+    std::string first{"a long enough string to skip small buffers"};
+    std::string second{"and another one to go past the capacity"};
+
+    Delegate<size_t()> original{[first, second]
+                                { return first.size() + second.size(); }};
+    Delegate<size_t()> copied{original};
+    Delegate<size_t()> moved{std::move(original)};
+
+    EXPECT_FALSE(original);
+    EXPECT_EQ(first.size() + second.size(), copied());
+    EXPECT_EQ(first.size() + second.size(), moved());
+
+    copied = moved;
+    moved.reset();
+
+    EXPECT_EQ(first.size() + second.size(), copied());
+}
+
+TEST(delegate_tests, forwards_reference_arguments)
+{
+    Delegate<void(std::string&)> delegate{[](std::string& text)
+                                          { text += "!"; }};
+
+    std::string text{"hi"};
+    delegate(text);
+
+    EXPECT_EQ("hi!", text);
+}
+
+TEST(functionref_tests, calls_borrowed_callable)
+{
+    int  calls{};
+    auto callable = [&calls](int value)
+    {
+        ++calls;
+
+        return value * 3;
+    };
+
+    FunctionRef<int(int)> function{callable};
+
+    EXPECT_EQ(9, function(3));
+    EXPECT_EQ(1, calls);
+}
+
+TEST(functionref_tests, can_be_passed_temporaries_as_parameter)
+{
+    auto apply = [](FunctionRef<int(int)> function) { return function(2); };
+
+    EXPECT_EQ(4, apply([](int value) { return value * 2; }));
+}
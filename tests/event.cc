@@ -1,5 +1,13 @@
 #include <gtest/gtest.h>
 #include <cpputils/event.hpp>
+#include <cpputils/task.hpp>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace cu::event::tests
 {
@@ -33,6 +41,24 @@ struct DummyEventListenerOwner
     }
 };
 
+struct CopyCounter
+{
+    static inline int copies{};
+    static inline int moves{};
+
+    CopyCounter() = default;
+
+    CopyCounter(const CopyCounter&)
+    {
+        ++copies;
+    }
+
+    CopyCounter(CopyCounter&&) noexcept
+    {
+        ++moves;
+    }
+};
+
 }
 
 TEST(event_tests, can_subscribe_to_event)
@@ -51,6 +77,23 @@ TEST(event_tests, can_subscribe_to_event)
     EXPECT_EQ(val, listener2.value1);
 }
 
+TEST(event_tests, listener_accepts_large_captures)
+{
+    std::string prefix{"a prefix long enough to skip small buffers "};
+    std::string suffix{" and a suffix to go past the capacity"};
+    std::string received;
+
+    cu::EventHandler<int>  event;
+    cu::EventListener<int> listener{
+        [prefix, suffix, &received](int value)
+        { received = prefix + std::to_string(value) + suffix; }};
+
+    event += listener;
+    event(7);
+
+    EXPECT_EQ(prefix + "7" + suffix, received);
+}
+
 TEST(event_tests, can_unsubscribe_from_event)
 {
     cu::event::tests::DummyEventOwner         eventOwner;
@@ -316,3 +359,244 @@ TEST(event_tests, unsubscribing_event_during_execution_will_not_affect_handler)
 
     EXPECT_EQ(2, val);
 }
+
+TEST(event_tests, can_unsubscribe_by_connection)
+{
+    int                val{};
+    cu::EventHandler<> event;
+
+    cu::EventListener<> listener([&val]() { ++val; });
+
+    auto connection1 = event.subscribe(listener);
+    auto connection2 = event.subscribe(listener);
+
+    event();
+    EXPECT_EQ(2, val);
+
+    event.unsubscribe(connection1);
+
+    EXPECT_FALSE(event.isConnected(connection1));
+    EXPECT_TRUE(event.isConnected(connection2));
+
+    event();
+    EXPECT_EQ(3, val);
+}
+
+TEST(event_tests, stale_connection_does_not_remove_reused_slot)
+{
+    int                val{};
+    cu::EventHandler<> event;
+
+    cu::EventListener<> listener1([&val]() { ++val; });
+    cu::EventListener<> listener2([&val]() { val += 10; });
+
+    auto stale = event.subscribe(listener1);
+    event -= listener1;
+
+    auto fresh = event.subscribe(listener2);
+
+    EXPECT_EQ(stale.index, fresh.index);
+
+    event.unsubscribe(stale);
+    event();
+
+    EXPECT_EQ(10, val);
+    EXPECT_EQ(1, event.listenerCount());
+}
+
+TEST(event_tests, destroying_listener_during_execution_skips_it)
+{
+    int                  val{};
+    cu::EventHandler<>   event;
+    cu::EventListener<>* l2Ptr{};
+
+    auto l2 = std::make_unique<cu::EventListener<>>([&val] { val += 10; });
+    l2Ptr   = l2.get();
+
+    cu::EventListener<> l1{[&l2, &val]
+                           {
+                               ++val;
+                               l2.reset();
+                           }};
+
+    event += l1;
+    event += *l2Ptr;
+    event();
+
+    EXPECT_EQ(1, val);
+    EXPECT_EQ(1, event.listenerCount());
+}
+
+TEST(event_tests, unsubscribing_keeps_other_subscriptions_of_listener)
+{
+    int                val{};
+    cu::EventHandler<> event1;
+    cu::EventHandler<> event2;
+    cu::EventHandler<> event3;
+
+    cu::EventListener<> listener([&val]() { ++val; });
+
+    event1 += listener;
+    event2 += listener;
+    event3 += listener;
+
+    event1 -= listener;
+
+    event1();
+    event2();
+    event3();
+
+    EXPECT_EQ(2, val);
+}
+
+TEST(event_tests, does_not_copy_arguments_per_listener)
+{
+    using cu::event::tests::CopyCounter;
+
+    cu::EventHandler<CopyCounter>  event;
+    cu::EventListener<CopyCounter> listener1([](const CopyCounter&) {});
+    cu::EventListener<CopyCounter> listener2([](const CopyCounter&) {});
+
+    event += listener1;
+    event += listener2;
+
+    CopyCounter::copies = 0;
+    CopyCounter::moves  = 0;
+
+    CopyCounter value;
+    event(value);
+
+    EXPECT_EQ(0, CopyCounter::copies);
+    EXPECT_EQ(0, CopyCounter::moves);
+}
+
+TEST(event_tests, mutable_reference_listener_gets_its_own_copy)
+{
+    cu::EventHandler<std::string>  event;
+    std::string                    received;
+    cu::EventListener<std::string> listener{[&received](std::string& text)
+                                            {
+                                                text += "!";
+                                                received = text;
+                                            }};
+    event += listener;
+
+    const std::string text{"hi"};
+    event(text);
+
+    EXPECT_EQ("hi!", received);
+    EXPECT_EQ("hi", text);
+}
+
+TEST(event_tests, emit_moving_moves_into_last_consuming_listener)
+{
+    using cu::event::tests::CopyCounter;
+
+    cu::EventHandler<CopyCounter> event;
+    int                           consumed{};
+
+    cu::EventListener<CopyCounter> observer([](const CopyCounter&) {});
+    auto consumer1 = cu::EventListener<CopyCounter>::consuming(
+        [&consumed](CopyCounter&&) { ++consumed; });
+    auto consumer2 = cu::EventListener<CopyCounter>::consuming(
+        [&consumed](CopyCounter&&) { ++consumed; });
+
+    event += consumer1;
+    event += observer;
+    event += consumer2;
+
+    CopyCounter::copies = 0;
+    CopyCounter::moves  = 0;
+
+    event.emitMoving(CopyCounter{});
+
+    EXPECT_EQ(2, consumed);
+    EXPECT_EQ(1, CopyCounter::copies);
+    EXPECT_EQ(0, CopyCounter::moves);
+
+    CopyCounter::copies = 0;
+    event(CopyCounter{});
+
+    EXPECT_EQ(4, consumed);
+    EXPECT_EQ(2, CopyCounter::copies);
+}
+
+TEST(event_tests, invoke_parallel_runs_every_listener_once)
+{
+    cu::ThreadPool                    pool{4};
+    cu::EventHandler<int>             event;
+    std::atomic<int>                  sum{};
+    int                               dependentCalls{};
+    std::list<cu::EventListener<int>> listeners;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto& listener = listeners.emplace_back([&sum](int value)
+                                                { sum += value; });
+        listener.setIndependent(true);
+        event += listener;
+    }
+
+    cu::EventListener<int> dependent([&dependentCalls](int)
+                                     { ++dependentCalls; });
+    event += dependent;
+
+    event.invokeParallel(pool, 64, 2);
+
+    EXPECT_EQ(2000, sum);
+    EXPECT_EQ(1, dependentCalls);
+}
+
+TEST(event_tests, invoke_parallel_rethrows_listener_exception)
+{
+    cu::ThreadPool      pool{2};
+    cu::EventHandler<>  event;
+    std::atomic<int>    calls{};
+    cu::EventListener<> thrower([] { throw std::runtime_error("failed"); });
+    cu::EventListener<> counter([&calls] { ++calls; });
+
+    thrower.setIndependent(true);
+    counter.setIndependent(true);
+    event += thrower;
+    event += counter;
+
+    EXPECT_THROW(event.invokeParallel(pool, 1), std::runtime_error);
+    EXPECT_EQ(1, calls);
+}
+
+TEST(event_tests, emit_batch_runs_listeners_over_whole_batch)
+{
+    using Batch = cu::EventListener<int, std::string>::BatchEvent;
+
+    cu::EventHandler<int, std::string> event;
+    std::vector<std::string>           calls;
+    size_t                             batchSize{};
+
+    cu::EventListener<int, std::string> first(
+        [&calls](int value, const std::string& name)
+        { calls.push_back("first " + name + std::to_string(value)); });
+    cu::EventListener<int, std::string> second(
+        [&calls](int value, const std::string& name)
+        { calls.push_back("second " + name + std::to_string(value)); });
+    auto batched = cu::EventListener<int, std::string>::batched(
+        [&batchSize](std::span<const Batch> events)
+        { batchSize += events.size(); });
+
+    event += first;
+    event += second;
+    event += batched;
+
+    std::vector<Batch> events{{1, "a"}, {2, "b"}};
+    event.emitBatch(events);
+
+    EXPECT_EQ((std::vector<std::string>{"first a1",
+                                        "first b2",
+                                        "second a1",
+                                        "second b2"}),
+              calls);
+    EXPECT_EQ(2, batchSize);
+
+    event(3, "c");
+
+    EXPECT_EQ(3, batchSize);
+}
@@ -0,0 +1,87 @@
+#include <cpputils/eventbus.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace cu::eventbus::tests
+{
+struct Moved
+{
+    int x;
+    int y;
+};
+
+struct Renamed
+{
+    std::string name;
+};
+}
+
+using cu::eventbus::tests::Moved;
+using cu::eventbus::tests::Renamed;
+
+TEST(eventbus_tests, routes_events_by_type)
+{
+    cu::EventBus bus;
+    int          moves{};
+    std::string  name;
+
+    cu::EventListener<const Moved&> onMoved(
+        [&moves](const Moved& event) { moves += event.x + event.y; });
+    cu::EventListener<const Renamed&> onRenamed(
+        [&name](const Renamed& event) { name = event.name; });
+
+    bus.subscribe<Moved>(onMoved);
+    bus.subscribe<Renamed>(onRenamed);
+
+    bus.publish(Moved{1, 2});
+    bus.publish(Renamed{"bus"});
+
+    EXPECT_EQ(3, moves);
+    EXPECT_EQ("bus", name);
+    EXPECT_EQ(1, bus.listenerCount<Moved>());
+}
+
+TEST(eventbus_tests, publishing_without_listeners_is_a_no_op)
+{
+    cu::EventBus bus;
+
+    bus.publish(Moved{1, 2});
+
+    EXPECT_EQ(0, bus.listenerCount<Moved>());
+}
+
+TEST(eventbus_tests, can_unsubscribe)
+{
+    cu::EventBus bus;
+    int          calls{};
+
+    cu::EventListener<const Moved&> listener1(
+        [&calls](const Moved&) { ++calls; });
+    cu::EventListener<const Moved&> listener2(
+        [&calls](const Moved&) { ++calls; });
+
+    bus.subscribe<Moved>(listener1);
+    auto connection = bus.subscribe<Moved>(listener2);
+
+    bus.unsubscribe<Moved>(listener1);
+    bus.publish(Moved{});
+    bus.unsubscribe<Moved>(connection);
+    bus.publish(Moved{});
+
+    EXPECT_EQ(1, calls);
+}
+
+TEST(eventbus_tests, moving_bus_keeps_listeners)
+{
+    cu::EventBus bus;
+    int          calls{};
+
+    cu::EventListener<const Moved&> listener(
+        [&calls](const Moved&) { ++calls; });
+    bus.subscribe<Moved>(listener);
+
+    auto moved = std::move(bus);
+    moved.publish(Moved{});
+
+    EXPECT_EQ(1, calls);
+}
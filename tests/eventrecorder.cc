@@ -0,0 +1,142 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cpputils/eventrecorder.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace cu::eventrecorder::tests
+{
+std::string logPath(const char* test)
+{
+    return "/tmp/cpputils_" + std::string{test} + "_" +
+           std::to_string(::getpid()) + ".log";
+}
+}
+
+using cu::eventrecorder::tests::logPath;
+
+TEST(eventrecorder_tests, replays_recorded_events)
+{
+    auto path = logPath("replay");
+
+    {
+        cu::EventHandler<int, const std::string&>  event;
+        cu::EventRecorder<int, const std::string&> recorder{event, path};
+
+        event(1, "one");
+        event(2, std::string(100'000, 'x'));
+        event(3, "three");
+
+        EXPECT_EQ(3, recorder.recordedCount());
+    }
+
+    cu::EventHandler<int, const std::string&> replayed;
+    std::vector<int>                          ids;
+    std::vector<size_t>                       sizes;
+
+    cu::EventListener<int, const std::string&> listener(
+        [&](int id, const std::string& text)
+        {
+            ids.push_back(id);
+            sizes.push_back(text.size());
+        });
+    replayed += listener;
+
+    cu::EventPlayer<int, const std::string&> player{path};
+
+    EXPECT_TRUE(player.emitNext(replayed));
+    EXPECT_EQ(2, player.play(replayed, cu::ReplaySpeed::maximum));
+    EXPECT_TRUE(player.finished());
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), ids);
+    EXPECT_EQ((std::vector<size_t>{3, 100'000, 5}), sizes);
+
+    player.rewind();
+    EXPECT_EQ(3, player.play(replayed, cu::ReplaySpeed::maximum));
+
+    std::remove(path.c_str());
+}
+
+TEST(eventrecorder_tests, original_speed_keeps_gaps)
+{
+    using namespace std::chrono_literals;
+
+    auto path = logPath("speed");
+
+    {
+        cu::EventHandler<int>  event;
+        cu::EventRecorder<int> recorder{event, path};
+
+        event(1);
+        std::this_thread::sleep_for(20ms);
+        event(2);
+    }
+
+    cu::EventHandler<int> replayed;
+    cu::EventPlayer<int>  player{path};
+    auto                  start = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(2, player.play(replayed));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+
+    std::remove(path.c_str());
+}
+
+TEST(eventrecorder_tests, stops_at_truncated_record)
+{
+    auto path = logPath("truncated");
+
+    {
+        cu::EventHandler<int>  event;
+        cu::EventRecorder<int> recorder{event, path};
+
+        event(1);
+        event(2);
+    }
+
+    // Each record is a 16 byte header and an int padded to 8 bytes.
+    auto firstRecordEnd = sizeof(cu::EventLog::Header) + 24;
+
+    cu::EventHandler<int>  replayed;
+    std::vector<int>       ids;
+    cu::EventListener<int> listener([&ids](int id) { ids.push_back(id); });
+    replayed += listener;
+
+    // Cut into the payload, after the header and into the header.
+    for (size_t cut : {20, 16, 4})
+    {
+        std::filesystem::resize_file(path, firstRecordEnd + cut);
+
+        cu::EventPlayer<int> player{path};
+
+        EXPECT_EQ(1, player.play(replayed, cu::ReplaySpeed::maximum));
+        EXPECT_TRUE(player.finished());
+        EXPECT_FALSE(player.emitNext(replayed));
+    }
+
+    EXPECT_EQ((std::vector<int>{1, 1, 1}), ids);
+
+    std::remove(path.c_str());
+}
+
+TEST(eventrecorder_tests, rejects_log_of_other_event_type)
+{
+    auto path = logPath("mismatch");
+
+    {
+        cu::EventHandler<int>  event;
+        cu::EventRecorder<int> recorder{event, path};
+    }
+
+    EXPECT_THROW((cu::EventPlayer<int, int>{path}), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(cu::EventPlayer<int>{path}, std::system_error);
+}
+
+#endif
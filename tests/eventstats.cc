@@ -0,0 +1,71 @@
+#include <cpputils/event.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <numeric>
+#include <thread>
+
+TEST(eventstats_tests, counts_emits_and_listener_calls)
+{
+    cu::EventHandler<int>  event;
+    cu::EventListener<int> fast([](int) {});
+    cu::EventListener<int> slow(
+        [](int)
+        { std::this_thread::sleep_for(std::chrono::milliseconds{1}); });
+
+    event += fast;
+    auto slowConnection = event.subscribe(slow);
+
+    event(1);
+    event(2);
+
+    auto stats = event.stats();
+
+    EXPECT_EQ(2, stats.emitCount);
+    EXPECT_EQ(2, stats.emitLatency.count);
+    ASSERT_EQ(2, stats.listeners.size());
+
+    auto& slowStats = stats.listeners[1];
+
+    EXPECT_EQ(slowConnection.index, slowStats.connection.index);
+    EXPECT_EQ(2, slowStats.latency.count);
+    EXPECT_GE(slowStats.latency.totalNanoseconds, 2'000'000);
+    EXPECT_GE(slowStats.latency.maxNanoseconds,
+              stats.listeners[0].latency.maxNanoseconds);
+    EXPECT_EQ(2,
+              std::accumulate(slowStats.latency.histogram.begin(),
+                              slowStats.latency.histogram.end(),
+                              uint64_t{}));
+}
+
+TEST(eventstats_tests, reports_deferred_removals)
+{
+    cu::EventHandler<>  event;
+    cu::EventListener<> other([] {});
+    cu::EventListener<> remover([&] { event -= other; });
+
+    event += remover;
+    event += other;
+
+    event();
+
+    auto stats = event.stats();
+
+    EXPECT_EQ(0, stats.pendingRemovals);
+    EXPECT_EQ(1, stats.peakPendingRemovals);
+    EXPECT_EQ(1, stats.listeners.size());
+}
+
+TEST(eventstats_tests, reset_clears_stats)
+{
+    cu::EventHandler<>  event;
+    cu::EventListener<> listener([] {});
+
+    event += listener;
+    event();
+    event.resetStats();
+
+    auto stats = event.stats();
+
+    EXPECT_EQ(0, stats.emitCount);
+    EXPECT_EQ(0, stats.listeners[0].latency.count);
+}
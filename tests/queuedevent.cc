@@ -0,0 +1,121 @@
+#include <cpputils/queuedevent.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(queuedevent_tests, listeners_run_on_drain)
+{
+    cu::QueuedEventHandler<const std::string&, int> event;
+    std::vector<std::string>                        received;
+
+    cu::EventListener<const std::string&, int> listener{
+        [&received](const std::string& text, int count)
+        { received.push_back(text + std::to_string(count)); }};
+    event += listener;
+
+    EXPECT_TRUE(event.post("a", 1));
+    EXPECT_TRUE(event.post(std::string{"b"}, 2));
+    EXPECT_TRUE(received.empty());
+
+    EXPECT_EQ(2, event.drain());
+    EXPECT_EQ((std::vector<std::string>{"a1", "b2"}), received);
+    EXPECT_TRUE(event.empty());
+}
+
+TEST(queuedevent_tests, post_fails_when_full)
+{
+    cu::QueuedEventHandler<int> event{3};
+
+    EXPECT_EQ(4, event.capacity());
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(event.post(i));
+
+    EXPECT_FALSE(event.post(4));
+    EXPECT_EQ(1, event.drain(1));
+    EXPECT_TRUE(event.post(4));
+}
+
+TEST(queuedevent_tests, drain_respects_batch_size)
+{
+    cu::QueuedEventHandler<int> event;
+    int                         sum{};
+
+    cu::EventListener<int> listener{[&sum](int value) { sum += value; }};
+    event += listener;
+
+    for (int i = 1; i <= 10; ++i)
+        event.post(i);
+
+    EXPECT_EQ(4, event.drain(4));
+    EXPECT_EQ(10, sum);
+    EXPECT_EQ(6, event.drain());
+    EXPECT_EQ(55, sum);
+    EXPECT_EQ(0, event.drain());
+}
+
+TEST(queuedevent_tests, keeps_order_per_producer)
+{
+    constexpr int producers = 4;
+    constexpr int perThread = 10000;
+
+    cu::QueuedEventHandler<int, int> event{256};
+    std::vector<int>                 last(producers, -1);
+    bool                             ordered = true;
+    int                              count{};
+
+    cu::EventListener<int, int> listener{
+        [&](int producer, int value)
+        {
+            ordered = ordered && last[producer] + 1 == value;
+            last[producer] = value;
+            ++count;
+        }};
+    event += listener;
+
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back(
+            [&event, p]
+            {
+                for (int i = 0; i < perThread; ++i)
+                    while (!event.post(p, i))
+                        std::this_thread::yield();
+            });
+
+    while (count < producers * perThread)
+        event.drain(32);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(producers * perThread, count);
+}
+
+TEST(queuedevent_tests, dispatcher_thread_delivers_events)
+{
+    cu::QueuedEventHandler<int> event;
+    std::atomic<int>            sum{};
+
+    cu::EventListener<int> listener{[&sum](int value) { sum += value; }};
+    event += listener;
+    event.start();
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        event.post(i);
+
+        if (0 == i % 10)
+            while (!event.empty())
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    event.stop();
+
+    EXPECT_EQ(5050, sum);
+    EXPECT_TRUE(event.empty());
+}
@@ -47,6 +47,54 @@ TEST(result_tests, move_semantics_work)
     EXPECT_EQ(resOriginal.message(), resMoveAssigned.message());
 }
 
+TEST(result_tests, context_frames_render_outermost_first)
+{
+    auto result = Result{false, "unexpected token"}
+                      .addContext("line", 12)
+                      .addContext("loading config");
+
+    EXPECT_EQ("unexpected token", result.message());
+    EXPECT_EQ(2, result.context().size());
+    EXPECT_EQ("loading config: line 12: unexpected token",
+              result.fullMessage());
+}
+
+TEST(result_tests, context_frames_stay_inline_for_typical_depths)
+{
+    Result result{false, "failed"};
+
+    for (int i = 0; i < 2; ++i)
+        result.addContext("layer", i);
+
+    EXPECT_TRUE(result.context().isInline());
+
+    for (int i = 2; i < 8; ++i)
+        result.addContext("layer", i);
+
+    EXPECT_EQ(8, result.context().size());
+    EXPECT_EQ(7, result.context()[7].value);
+}
+
+TEST(dataresult_tests, propagate_keeps_message_and_context)
+{
+    DataResult<int> inner{"not found"};
+    inner.addContext("opening file");
+
+    auto outer = DataResult<std::string>::propagate(inner).addContext(
+        "reading settings");
+
+    EXPECT_TRUE(outer.failed());
+    EXPECT_EQ("reading settings: opening file: not found",
+              outer.fullMessage());
+}
+
+TEST(dataresult_tests, propagate_throws_for_succeeded_result)
+{
+    DataResult<int> inner{42};
+
+    EXPECT_THROW(DataResult<std::string>::propagate(inner), std::runtime_error);
+}
+
 TEST(dataresult_tests, returns_correct_data)
 {
     int              val;
@@ -212,6 +260,72 @@ TEST(resultcollector_tests, non_empty_messages_gets_added_to_list)
     EXPECT_EQ(3, collector.messages().size());
 }
 
+TEST(resultcollector_tests, collected_messages_keep_context)
+{
+    ResultCollector collector;
+    collector.addResult(Result{false, "not found"}.addContext("opening file"));
+
+    ASSERT_EQ(1, collector.messages().size());
+    EXPECT_EQ("opening file: not found", collector.messages().front());
+}
+
+TEST(resultcollector_tests, deduplicating_collector_counts_identical_messages)
+{
+    auto collector = ResultCollector::deduplicating();
+
+    for (int i = 0; i < 1000; ++i)
+        collector.addResult(Result{false, "row is invalid"});
+
+    collector.addResult(Result{true, "done"});
+    collector.addResult(Result{true});
+
+    auto& counts = collector.messageCounts();
+
+    ASSERT_EQ(2, counts.size());
+    EXPECT_EQ("row is invalid", counts[0].message);
+    EXPECT_EQ(1000, counts[0].count);
+    EXPECT_EQ("done", counts[1].message);
+    EXPECT_EQ(1, counts[1].count);
+    EXPECT_TRUE(collector.messages().empty());
+    EXPECT_TRUE(collector.anyFailed());
+    EXPECT_TRUE(collector.anySucceeded());
+}
+
+TEST(resultcollector_tests, deduplicating_collector_drops_messages_beyond_cap)
+{
+    auto collector = ResultCollector::deduplicating(2);
+
+    collector.addResult(Result{false, "a"});
+    collector.addResult(Result{false, "b"});
+    collector.addResult(Result{false, "c"});
+    collector.addResult(Result{false, "a"});
+    collector.addResult(Result{false, "d"});
+
+    auto& counts = collector.messageCounts();
+
+    ASSERT_EQ(2, counts.size());
+    EXPECT_EQ(2, counts[0].count);
+    EXPECT_EQ(1, counts[1].count);
+    EXPECT_EQ(2, collector.droppedMessageCount());
+}
+
+TEST(resultcollector_tests, copying_deduplicating_collector_copies_counts)
+{
+    auto original = ResultCollector::deduplicating();
+    original.addResult(Result{false, "msg"});
+    original.addResult(Result{false, "msg"});
+
+    ResultCollector copy{original};
+    original = ResultCollector{};
+
+    copy.addResult(Result{false, "msg"});
+
+    ASSERT_EQ(1, copy.messageCounts().size());
+    EXPECT_EQ("msg", copy.messageCounts()[0].message);
+    EXPECT_EQ(3, copy.messageCounts()[0].count);
+    EXPECT_TRUE(copy.deduplicates());
+}
+
 TEST(statusactionmapper_tests, execute_calls_binded_callback)
 {
     StatusActionMapper<std::string> mapper;
@@ -229,3 +343,139 @@ TEST(statusactionmapper_tests, execute_calls_binded_callback)
     EXPECT_TRUE(status2Executed);
     EXPECT_FALSE(status3Executed);
 }
+
+TEST(statusactionmapper_tests, rebinding_status_replaces_callback)
+{
+    StatusActionMapper<std::string> mapper;
+    int                             value{};
+
+    mapper.bind("status", [&value] { value = 1; });
+    mapper.bind("status", [&value] { value = 2; });
+
+    mapper.execute("status");
+    mapper.execute("unknown");
+
+    EXPECT_EQ(2, value);
+}
+
+TEST(statusactionmapper_tests, execute_calls_binded_callback_for_enum_status)
+{
+    enum class ResponseStatus
+    {
+        ok,
+        notFound,
+        denied
+    };
+
+    StatusActionMapper<ResponseStatus> mapper;
+    int                                okCount{};
+    int                                deniedCount{};
+
+    mapper.bind(ResponseStatus::denied, [&deniedCount] { ++deniedCount; });
+    mapper.bind(ResponseStatus::ok, [&okCount] { ++okCount; });
+
+    mapper.execute(ResponseStatus::ok);
+    mapper.execute(ResponseStatus::notFound);
+    mapper.execute(ResponseStatus::denied);
+    mapper.execute(ResponseStatus::ok);
+
+    EXPECT_EQ(2, okCount);
+    EXPECT_EQ(1, deniedCount);
+}
+
+TEST(statusactionmapper_tests, execute_calls_binded_callback_for_sparse_integers)
+{
+    StatusActionMapper<int> mapper;
+    std::string             executed;
+
+    mapper.bind(200, [&executed] { executed += "a"; });
+    mapper.bind(-5, [&executed] { executed += "b"; });
+    mapper.bind(1'000'000, [&executed] { executed += "c"; });
+    mapper.bind(404, [&executed] { executed += "d"; });
+
+    mapper.execute(1'000'000);
+    mapper.execute(404);
+    mapper.execute(-5);
+    mapper.execute(200);
+    mapper.execute(201);
+    mapper.execute(-1'000'000);
+
+    EXPECT_EQ("cdba", executed);
+}
+
+TEST(resultbatch_tests, new_batch_has_all_succeeded)
+{
+    ResultBatch batch{130};
+
+    EXPECT_EQ(130, batch.size());
+    EXPECT_TRUE(batch.allSucceeded());
+    EXPECT_EQ(0, batch.countFailed());
+}
+
+TEST(resultbatch_tests, failures_are_counted_and_reported_in_order)
+{
+    ResultBatch batch{200};
+
+    batch.setFailed(150, "too large");
+    batch.setFailed(3);
+    batch.setFailed(64, "negative");
+    batch.setFailed(199, "missing");
+
+    std::vector<size_t>      indices;
+    std::vector<std::string> messages;
+
+    batch.forEachFailure(
+        [&](size_t index, std::string_view message)
+        {
+            indices.push_back(index);
+            messages.emplace_back(message);
+        });
+
+    EXPECT_FALSE(batch.allSucceeded());
+    EXPECT_EQ(4, batch.countFailed());
+    EXPECT_EQ((std::vector<size_t>{3, 64, 150, 199}), indices);
+    EXPECT_EQ((std::vector<std::string>{"", "negative", "too large", "missing"}),
+              messages);
+}
+
+TEST(resultbatch_tests, setting_success_clears_failure_and_message)
+{
+    ResultBatch batch{10};
+
+    batch.setFailed(5, "bad");
+    batch.setSucceeded(5);
+
+    EXPECT_TRUE(batch.succeeded(5));
+    EXPECT_TRUE(batch.message(5).empty());
+    EXPECT_TRUE(batch.allSucceeded());
+}
+
+TEST(resultbatch_tests, result_materializes_single_outcome)
+{
+    ResultBatch batch{3};
+
+    batch.set(1, Result{false, "bad"}.addContext("row", 1));
+
+    auto failure = batch.result(1);
+    auto success = batch.result(2);
+
+    EXPECT_TRUE(failure.failed());
+    EXPECT_EQ("row 1: bad", failure.message());
+    EXPECT_TRUE(success.succeeded());
+}
+
+TEST(resultbatch_tests, copied_batch_keeps_failures_after_original_is_reset)
+{
+    ResultBatch original{64};
+    original.setFailed(63, "last");
+
+    ResultBatch copy{original};
+    original.reset(0);
+
+    auto failures = copy.failures();
+
+    ASSERT_EQ(1, failures.size());
+    EXPECT_EQ(63, failures[0].index);
+    EXPECT_EQ("last", failures[0].message);
+    EXPECT_TRUE(original.allSucceeded());
+}
@@ -0,0 +1,140 @@
+#if defined(__linux__)
+
+#include <cpputils/shmevent.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace cu::shmevent::tests
+{
+struct Tick
+{
+    int    id;
+    double value;
+};
+
+std::string channelName(const char* test)
+{
+    return "/cpputils_" + std::string{test} + "_" + std::to_string(::getpid());
+}
+}
+
+using cu::shmevent::tests::Tick;
+using cu::shmevent::tests::channelName;
+
+TEST(shmevent_tests, delivers_published_events_to_other_handles)
+{
+    auto name      = channelName("deliver");
+    auto publisher = cu::ShmEventChannel<Tick>::create(name, 8);
+    auto reader    = cu::ShmEventChannel<Tick>::open(name);
+    cu::ShmEventChannel<Tick>::unlink(name);
+
+    std::vector<int>               ids;
+    cu::EventListener<const Tick&> listener(
+        [&ids](const Tick& tick) { ids.push_back(tick.id); });
+    reader += listener;
+
+    publisher.publish({1, 1.5});
+    publisher.publish({2, 2.5});
+
+    EXPECT_EQ(2, reader.poll());
+    EXPECT_EQ((std::vector<int>{1, 2}), ids);
+    EXPECT_EQ(0, reader.poll());
+}
+
+TEST(shmevent_tests, slow_reader_skips_overwritten_events)
+{
+    auto name      = channelName("overrun");
+    auto publisher = cu::ShmEventChannel<Tick>::create(name, 4);
+    auto reader    = cu::ShmEventChannel<Tick>::open(name);
+    cu::ShmEventChannel<Tick>::unlink(name);
+
+    std::vector<int>               ids;
+    cu::EventListener<const Tick&> listener(
+        [&ids](const Tick& tick) { ids.push_back(tick.id); });
+    reader += listener;
+
+    for (int i = 0; i < 10; ++i)
+        publisher.publish({i, 0});
+
+    reader.poll();
+
+    EXPECT_EQ((std::vector<int>{6, 7, 8, 9}), ids);
+    EXPECT_EQ(6, reader.droppedCount());
+}
+
+TEST(shmevent_tests, rejects_mismatched_event_type)
+{
+    auto name    = channelName("mismatch");
+    auto channel = cu::ShmEventChannel<Tick>::create(name, 4);
+
+    EXPECT_THROW(cu::ShmEventChannel<int>::open(name), std::runtime_error);
+    cu::ShmEventChannel<Tick>::unlink(name);
+    EXPECT_THROW(cu::ShmEventChannel<Tick>::open(name), std::system_error);
+}
+
+TEST(shmevent_tests, recreating_channel_leaves_open_handles_intact)
+{
+    auto name      = channelName("recreate");
+    auto publisher = cu::ShmEventChannel<Tick>::create(name, 8);
+    auto reader    = cu::ShmEventChannel<Tick>::open(name);
+
+    std::vector<int>               ids;
+    cu::EventListener<const Tick&> listener(
+        [&ids](const Tick& tick) { ids.push_back(tick.id); });
+    reader += listener;
+
+    publisher.publish({1, 0});
+
+    auto replacement = cu::ShmEventChannel<Tick>::create(name, 8);
+    cu::ShmEventChannel<Tick>::unlink(name);
+
+    publisher.publish({2, 0});
+
+    EXPECT_EQ(2, reader.poll());
+    EXPECT_EQ((std::vector<int>{1, 2}), ids);
+}
+
+TEST(shmevent_tests, wakes_reader_in_other_process)
+{
+    auto name   = channelName("process");
+    auto reader = cu::ShmEventChannel<Tick>::create(name, 64);
+    cu::ShmEventChannel<Tick>::unlink(name);
+
+    auto child = ::fork();
+    ASSERT_NE(-1, child);
+
+    if (0 == child)
+    {
+        ::usleep(10000);
+
+        for (int i = 0; i < 20; ++i)
+            reader.publish({i, i * 0.5});
+
+        ::_exit(0);
+    }
+
+    int                            sum{};
+    int                            received{};
+    cu::EventListener<const Tick&> listener(
+        [&](const Tick& tick)
+        {
+            sum += tick.id;
+            ++received;
+        });
+    reader += listener;
+
+    while (received < 20 && reader.wait(std::chrono::seconds{5}))
+        reader.poll();
+
+    int status{};
+    ::waitpid(child, &status, 0);
+
+    EXPECT_EQ(20, received);
+    EXPECT_EQ(190, sum);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include <cpputils/smallvector.hpp>
+#include <gtest/gtest.h>
+
+using namespace cu;
+
+TEST(smallvector_tests, stays_inline_within_capacity)
+{
+    SmallVector<int, 4> vector;
+
+    for (int i = 0; i < 4; ++i)
+        vector.push_back(i);
+
+    EXPECT_TRUE(vector.isInline());
+    EXPECT_EQ(4, vector.size());
+    EXPECT_EQ(3, vector[3]);
+}
+
+TEST(smallvector_tests, grows_to_heap_keeping_elements)
+{
+    SmallVector<int, 2> vector;
+
+    for (int i = 0; i < 10; ++i)
+        vector.push_back(i);
+
+    EXPECT_FALSE(vector.isInline());
+    ASSERT_EQ(10, vector.size());
+
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(i, vector[i]);
+}
+
+TEST(smallvector_tests, pushing_own_element_while_growing_is_safe)
+{
+    SmallVector<int, 1> vector;
+    vector.push_back(7);
+    vector.push_back(vector[0]);
+
+    EXPECT_EQ(7, vector[1]);
+}
+
+TEST(smallvector_tests, copy_and_move_semantics_work)
+{
+    SmallVector<int, 2> inlineVector;
+    inlineVector.push_back(1);
+
+    SmallVector<int, 2> heapVector;
+
+    for (int i = 0; i < 5; ++i)
+        heapVector.push_back(i);
+
+    SmallVector<int, 2> inlineCopy{inlineVector};
+    SmallVector<int, 2> heapCopy;
+    heapCopy = heapVector;
+    SmallVector<int, 2> inlineMoved{std::move(inlineVector)};
+    SmallVector<int, 2> heapMoved;
+    heapMoved = std::move(heapVector);
+
+    EXPECT_EQ(1, inlineCopy[0]);
+    EXPECT_EQ(4, heapCopy[4]);
+    EXPECT_EQ(1, inlineMoved[0]);
+    EXPECT_EQ(4, heapMoved[4]);
+    EXPECT_TRUE(inlineVector.empty());
+    EXPECT_TRUE(heapVector.empty());
+}
@@ -0,0 +1,72 @@
+#include <cpputils/staticevent.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace cu::staticevent::tests
+{
+std::vector<std::string> calls;
+
+void onValue(int value)
+{
+    calls.push_back("free " + std::to_string(value));
+}
+
+struct Counter
+{
+    int total{};
+
+    void add(int value)
+    {
+        total += value;
+        calls.push_back("member " + std::to_string(value));
+    }
+};
+
+Counter counter;
+}
+
+namespace tests = cu::staticevent::tests;
+
+TEST(staticevent_tests, calls_listeners_in_order)
+{
+    tests::calls.clear();
+    tests::counter = {};
+
+    cu::StaticEvent<
+        &tests::onValue,
+        cu::bound<tests::counter, &tests::Counter::add>,
+        [](int value)
+        { tests::calls.push_back("lambda " + std::to_string(value)); }>
+        event;
+
+    event(2);
+
+    EXPECT_EQ((std::vector<std::string>{"free 2", "member 2", "lambda 2"}),
+              tests::calls);
+    EXPECT_EQ(2, tests::counter.total);
+    EXPECT_EQ(3, decltype(event)::listenerCount);
+}
+
+TEST(staticevent_tests, can_extend_listener_list)
+{
+    tests::calls.clear();
+
+    using Event    = cu::StaticEvent<&tests::onValue>;
+    using Extended = Event::With<&tests::onValue>;
+
+    Extended::emit(5);
+
+    EXPECT_EQ(2, tests::calls.size());
+    EXPECT_EQ(0, cu::StaticEvent<>::listenerCount);
+}
+
+TEST(staticevent_tests, passes_arguments_by_reference)
+{
+    std::string text = "a";
+
+    cu::StaticEvent<[](std::string& value) { value += "b"; },
+                    [](std::string& value) { value += "c"; }>::emit(text);
+
+    EXPECT_EQ("abc", text);
+}
@@ -0,0 +1,53 @@
+#include <cpputils/stringarena.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace cu;
+
+TEST(stringarena_tests, stored_views_compare_equal_to_input)
+{
+    StringArena arena;
+
+    auto view1 = arena.store("first");
+    auto view2 = arena.store("second");
+
+    EXPECT_EQ("first", view1);
+    EXPECT_EQ("second", view2);
+    EXPECT_EQ(11, arena.bytesUsed());
+}
+
+TEST(stringarena_tests, stored_views_survive_block_growth)
+{
+    StringArena arena{8};
+
+    auto view1 = arena.store("1234567");
+    auto view2 = arena.store("abcdefg");
+    auto view3 = arena.store(std::string(32, 'x'));
+
+    EXPECT_EQ("1234567", view1);
+    EXPECT_EQ("abcdefg", view2);
+    EXPECT_EQ(std::string(32, 'x'), view3);
+    EXPECT_EQ(3, arena.blockCount());
+}
+
+TEST(stringarena_tests, oversized_string_does_not_waste_current_block)
+{
+    StringArena arena{8};
+
+    arena.store("1234");
+    arena.store(std::string(32, 'x'));
+    arena.store("abcd");
+
+    EXPECT_EQ(2, arena.blockCount());
+}
+
+TEST(stringarena_tests, clear_releases_blocks)
+{
+    StringArena arena;
+
+    arena.store("message");
+    arena.clear();
+
+    EXPECT_EQ(0, arena.blockCount());
+    EXPECT_EQ(0, arena.bytesUsed());
+}
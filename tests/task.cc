@@ -0,0 +1,248 @@
+#include <cpputils/task.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace cu;
+
+TEST(threadpool_tests, runs_submitted_jobs_before_destruction)
+{
+    std::atomic<int> count{};
+
+    {
+        ThreadPool pool{4};
+
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&count] { ++count; });
+    }
+
+    EXPECT_EQ(1000, count);
+}
+
+TEST(threadpool_tests, parallel_for_covers_every_index_once)
+{
+    ThreadPool                    pool{4};
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallelFor(visits.size(),
+                     16,
+                     [&visits](size_t first, size_t last)
+                     {
+                         EXPECT_LE(last - first, 16);
+
+                         for (auto i = first; i < last; ++i)
+                             ++visits[i];
+                     });
+
+    for (auto& count : visits)
+        ASSERT_EQ(1, count);
+}
+
+TEST(threadpool_tests, parallel_for_rethrows_after_every_chunk_ran)
+{
+    ThreadPool       pool{2};
+    std::atomic<int> chunks{};
+
+    EXPECT_THROW(pool.parallelFor(64,
+                                  4,
+                                  [&chunks](size_t first, size_t)
+                                  {
+                                      ++chunks;
+
+                                      if (0 == first)
+                                          throw std::runtime_error("failed");
+                                  }),
+                 std::runtime_error);
+    EXPECT_EQ(16, chunks);
+}
+
+TEST(task_tests, spawn_produces_result)
+{
+    ThreadPool pool{2};
+
+    auto task = spawn(pool, [] { return DataResult<int>{42}; });
+
+    EXPECT_TRUE(task.get().succeeded());
+    EXPECT_EQ(42, task.get().data());
+}
+
+TEST(task_tests, exceptions_become_failed_results)
+{
+    ThreadPool pool{2};
+
+    auto task = spawn(pool,
+                      []() -> DataResult<int>
+                      { throw std::runtime_error("broken"); });
+
+    EXPECT_TRUE(task.get().failed());
+    EXPECT_EQ("broken", task.get().message());
+}
+
+TEST(task_tests, then_receives_data_of_succeeded_result)
+{
+    ThreadPool pool{2};
+
+    auto task = spawn(pool, [] { return DataResult<int>{20}; })
+                    .then([](int& value) { return DataResult<int>{value + 1}; })
+                    .then([](int& value) { return DataResult<int>{value * 2}; });
+
+    EXPECT_EQ(42, task.get().data());
+}
+
+TEST(task_tests, then_short_circuits_on_failure)
+{
+    ThreadPool pool{2};
+    bool       called{};
+
+    auto task = spawn(pool, [] { return DataResult<int>{"parse error"}; })
+                    .then(
+                        [&called](int&)
+                        {
+                            called = true;
+
+                            return Result{};
+                        });
+
+    EXPECT_TRUE(task.get().failed());
+    EXPECT_EQ("parse error", task.get().message());
+    EXPECT_FALSE(called);
+}
+
+TEST(task_tests, then_keeps_context_of_failure)
+{
+    auto task = Task<DataResult<int>>::completed(
+                    DataResult<int>{"no such row"}.addContext("query", 3))
+                    .then([](int& value) { return DataResult<int>{value}; });
+
+    EXPECT_EQ("query 3: no such row", task.get().fullMessage());
+}
+
+TEST(task_tests, then_on_completed_task_runs_inline)
+{
+    auto task = Task<Result>::completed(Result{})
+                    .then([] { return DataResult<int>{7}; });
+
+    EXPECT_TRUE(task.ready());
+    EXPECT_EQ(7, task.get().data());
+}
+
+TEST(task_tests, when_all_collects_data_in_order)
+{
+    ThreadPool                          pool{4};
+    std::vector<Task<DataResult<int>>> tasks;
+
+    for (int i = 0; i < 100; ++i)
+        tasks.push_back(spawn(pool, [i] { return DataResult<int>{i}; }));
+
+    auto all = whenAll(std::move(tasks));
+    auto& values = all.get().data();
+
+    ASSERT_EQ(100, values.size());
+    EXPECT_EQ(4950, std::accumulate(values.begin(), values.end(), 0));
+    EXPECT_EQ(57, values[57]);
+}
+
+TEST(task_tests, when_all_fails_with_first_failure)
+{
+    ThreadPool              pool{4};
+    std::vector<Task<Result>> tasks;
+
+    tasks.push_back(spawn(pool, [] { return Result{}; }));
+    tasks.push_back(spawn(pool, [] { return Result{false, "disk full"}; }));
+    tasks.push_back(spawn(pool, [] { return Result{}; }));
+
+    auto all = whenAll(std::move(tasks));
+
+    EXPECT_TRUE(all.get().failed());
+    EXPECT_EQ("disk full", all.get().message());
+}
+
+TEST(task_tests, when_any_resolves_with_first_success)
+{
+    ThreadPool                          pool{4};
+    std::vector<Task<DataResult<int>>> tasks;
+
+    tasks.push_back(spawn(pool, [] { return DataResult<int>{"timeout"}; }));
+    tasks.push_back(spawn(pool, [] { return DataResult<int>{3}; }));
+
+    auto any = whenAny(std::move(tasks));
+
+    EXPECT_TRUE(any.get().succeeded());
+    EXPECT_EQ(3, any.get().data());
+}
+
+TEST(task_tests, when_any_fails_when_all_failed)
+{
+    ThreadPool              pool{2};
+    std::vector<Task<Result>> tasks;
+
+    tasks.push_back(spawn(pool, [] { return Result{false, "a"}; }));
+    tasks.push_back(spawn(pool, [] { return Result{false, "a"}; }));
+
+    auto any = whenAny(std::move(tasks));
+
+    EXPECT_TRUE(any.get().failed());
+    EXPECT_EQ("a", any.get().message());
+}
+
+TEST(task_tests, group_outcome_holds_when_members_finish_concurrently)
+{
+    ThreadPool pool{4};
+
+    for (int round = 0; round < 200; ++round)
+    {
+        std::vector<Task<DataResult<int>>> allTasks;
+        std::vector<Task<Result>>          anyTasks;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            bool odd = 0 != (round + i) % 8;
+
+            allTasks.push_back(spawn(pool,
+                                     [odd, i]
+                                     {
+                                         return odd ? DataResult<int>{i}
+                                                    : DataResult<int>{"bad"};
+                                     }));
+            anyTasks.push_back(
+                spawn(pool, [odd] { return Result{odd, "failed"}; }));
+        }
+
+        auto all = whenAll(std::move(allTasks));
+        auto any = whenAny(std::move(anyTasks));
+
+        ASSERT_TRUE(all.get().failed());
+        ASSERT_EQ("bad", all.get().message());
+        ASSERT_TRUE(any.get().succeeded());
+    }
+}
+
+TEST(task_tests, waiting_inside_worker_does_not_deadlock_single_thread_pool)
+{
+    ThreadPool pool{1};
+
+    auto outer = spawn(pool,
+                       [&pool]
+                       {
+                           auto inner =
+                               spawn(pool, [] { return DataResult<int>{5}; });
+
+                           return DataResult<int>{inner.get().data() + 1};
+                       });
+
+    EXPECT_EQ(6, outer.get().data());
+}
+
+TEST(task_tests, many_continuations_resolve)
+{
+    ThreadPool                 pool{4};
+    std::vector<Task<Result>> tasks;
+
+    for (int i = 0; i < 2000; ++i)
+        tasks.push_back(spawn(pool, [] { return DataResult<int>{1}; })
+                            .then([](int&) { return Result{}; }));
+
+    EXPECT_TRUE(whenAll(std::move(tasks)).get().succeeded());
+}